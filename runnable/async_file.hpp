@@ -0,0 +1,543 @@
+/**
+ * Coroutine-based asynchronous file reads on io_uring. Requires C++20 and Linux.
+ *
+ * async_reader owns an io_uring instance talking to the kernel through raw syscalls (no
+ * liburing needed). A coroutine returning io_task does `co_await reader.read(fd, buf, off)`
+ * and gets back the byte count or -errno, like pread. Reads only queue a submission entry;
+ * run() submits everything queued in one io_uring_enter() call, reaps all completions and
+ * resumes their coroutines, which queue their next reads for the following batch -- so one
+ * thread keeps many reads in flight. At most `queue_depth` reads are in flight; further reads
+ * wait in FIFO order for a free slot. Like read(2) on Linux, a single read transfers at most
+ * max_read_size bytes (just under 2 GiB); a larger buffer is clamped to that and the read
+ * comes back short, so a caller filling a larger buffer loops as it would on pread.
+ *
+ * With `registered_buffer_size` set, the reader also allocates one buffer per queue slot and
+ * registers it with the kernel, which then skips pinning the pages on every read; read_fixed()
+ * reads into such a buffer. Where io_uring is unavailable (old kernel, seccomp, containers
+ * that disable it) the same interface is served by a small pool of threads doing pread(), and
+ * coroutines are still resumed on the thread that calls run().
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <new>
+#include <mutex>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifndef __ASYNC_FILE_HPP__
+#define __ASYNC_FILE_HPP__
+
+////////////////////
+// Coroutine task //
+////////////////////
+
+// starts running immediately and is resumed by whoever completes what it awaits; the task
+// object owns the coroutine frame and reports completion and exceptions. A task destroyed
+// while its coroutine is suspended on a read cannot free the frame, which holds the read's
+// state and usually its buffer: the coroutine is detached instead, runs to completion on the
+// following run() calls and then frees itself, and anything it throws by then is dropped
+class io_task
+{
+public:
+    struct promise_type
+    {
+        std::exception_ptr error;
+        bool detached = false; // the task is gone; the frame frees itself when it finishes
+
+        struct final_awaiter
+        {
+            bool await_ready() const noexcept { return false; }
+            // not suspending lets the frame be destroyed as the coroutine ends
+            bool await_suspend(std::coroutine_handle<promise_type> h) const noexcept
+            {
+                return !h.promise().detached;
+            }
+            void await_resume() const noexcept {}
+        };
+
+        io_task get_return_object()
+        {
+            return io_task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        final_awaiter final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    explicit io_task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+    io_task(io_task &&o) noexcept : handle(std::exchange(o.handle, {})) {}
+    io_task &operator=(io_task &&o) noexcept
+    {
+        if (this != &o)
+        {
+            release();
+            handle = std::exchange(o.handle, {});
+        }
+        return *this;
+    }
+    io_task(const io_task &) = delete;
+    io_task &operator=(const io_task &) = delete;
+    ~io_task() { release(); }
+
+    bool done() const { return !handle || handle.done(); }
+
+    // rethrows what the coroutine threw, if anything
+    void get() const
+    {
+        if (handle && handle.promise().error)
+            std::rethrow_exception(handle.promise().error);
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    void release()
+    {
+        if (!handle)
+            return;
+        if (handle.done())
+            handle.destroy();
+        else
+            handle.promise().detached = true; // a read still refers to the frame
+    }
+};
+
+namespace async_file_detail
+{
+    struct read_op
+    {
+        int fd;
+        std::byte *buf;
+        uint32_t len;
+        uint64_t offset;
+        int buf_index; // registered buffer, or -1
+        int64_t result;
+        std::coroutine_handle<> waiter;
+    };
+
+    // MAX_RW_COUNT: the most one read(2) transfers, and well within the 32-bit SQE length
+    constexpr std::size_t max_read_size = 0x7ffff000;
+
+    struct free_deleter
+    {
+        void operator()(void *p) const { std::free(p); }
+    };
+
+    // minimal io_uring over raw syscalls: one SQ/CQ pair, reads only
+    class uring
+    {
+        int fd = -1;
+        void *sq_ring = MAP_FAILED, *cq_ring = MAP_FAILED;
+        std::size_t sq_ring_len = 0, cq_ring_len = 0;
+        io_uring_sqe *sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+        std::size_t sqes_len = 0;
+
+        unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+        unsigned *cq_head, *cq_tail, *cq_mask;
+        io_uring_cqe *cqes;
+        unsigned queued = 0; // entries written since the last submit
+
+        template <typename T>
+        static T *at(void *base, unsigned offset)
+        {
+            return reinterpret_cast<T *>(static_cast<char *>(base) + offset);
+        }
+
+        // the kernel reads the SQ tail and writes the CQ tail concurrently with us
+        static unsigned load_acquire(unsigned *p)
+        {
+            return std::atomic_ref<unsigned>(*p).load(std::memory_order_acquire);
+        }
+        static void store_release(unsigned *p, unsigned v)
+        {
+            std::atomic_ref<unsigned>(*p).store(v, std::memory_order_release);
+        }
+
+    public:
+        uring() = default;
+        uring(const uring &) = delete;
+        uring &operator=(const uring &) = delete;
+        ~uring()
+        {
+            if (sqes != MAP_FAILED)
+                ::munmap(sqes, sqes_len);
+            if (cq_ring != MAP_FAILED && cq_ring != sq_ring)
+                ::munmap(cq_ring, cq_ring_len);
+            if (sq_ring != MAP_FAILED)
+                ::munmap(sq_ring, sq_ring_len);
+            if (fd >= 0)
+                ::close(fd);
+        }
+
+        // returns false when the kernel refuses io_uring; the object is then unusable
+        bool open(unsigned entries)
+        {
+            io_uring_params p;
+            std::memset(&p, 0, sizeof(p));
+            fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &p));
+            if (fd < 0)
+                return false;
+            sq_ring_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+            cq_ring_len = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+            if (p.features & IORING_FEAT_SINGLE_MMAP)
+                sq_ring_len = cq_ring_len = std::max(sq_ring_len, cq_ring_len);
+            sq_ring = ::mmap(nullptr, sq_ring_len, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+            if (sq_ring == MAP_FAILED)
+                return false;
+            cq_ring = (p.features & IORING_FEAT_SINGLE_MMAP)
+                          ? sq_ring
+                          : ::mmap(nullptr, cq_ring_len, PROT_READ | PROT_WRITE,
+                                   MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (cq_ring == MAP_FAILED)
+                return false;
+            sqes_len = p.sq_entries * sizeof(io_uring_sqe);
+            sqes = static_cast<io_uring_sqe *>(::mmap(nullptr, sqes_len, PROT_READ | PROT_WRITE,
+                                                      MAP_SHARED | MAP_POPULATE, fd,
+                                                      IORING_OFF_SQES));
+            if (sqes == MAP_FAILED)
+                return false;
+            sq_head = at<unsigned>(sq_ring, p.sq_off.head);
+            sq_tail = at<unsigned>(sq_ring, p.sq_off.tail);
+            sq_mask = at<unsigned>(sq_ring, p.sq_off.ring_mask);
+            sq_array = at<unsigned>(sq_ring, p.sq_off.array);
+            cq_head = at<unsigned>(cq_ring, p.cq_off.head);
+            cq_tail = at<unsigned>(cq_ring, p.cq_off.tail);
+            cq_mask = at<unsigned>(cq_ring, p.cq_off.ring_mask);
+            cqes = at<io_uring_cqe>(cq_ring, p.cq_off.cqes);
+            return true;
+        }
+
+        bool register_buffers(const iovec *iovs, unsigned n)
+        {
+            return ::syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, iovs, n) == 0;
+        }
+
+        // the caller keeps the number of reads in flight within the ring size
+        void queue_read(read_op *op, bool fixed)
+        {
+            unsigned tail = *sq_tail;
+            unsigned index = tail & *sq_mask;
+            io_uring_sqe *sqe = &sqes[index];
+            std::memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+            sqe->fd = op->fd;
+            sqe->addr = reinterpret_cast<uint64_t>(op->buf);
+            sqe->len = op->len;
+            sqe->off = op->offset;
+            if (fixed)
+                sqe->buf_index = static_cast<uint16_t>(op->buf_index);
+            sqe->user_data = reinterpret_cast<uint64_t>(op);
+            sq_array[index] = index;
+            store_release(sq_tail, tail + 1);
+            ++queued;
+        }
+
+        // one syscall: hands over every queued entry and waits for at least one completion;
+        // returns 0, or the -errno io_uring_enter failed with
+        int submit_and_wait()
+        {
+            for (;;)
+            {
+                int ret = static_cast<int>(::syscall(__NR_io_uring_enter, fd, queued, 1,
+                                                     IORING_ENTER_GETEVENTS, nullptr, 0));
+                if (ret >= 0)
+                {
+                    queued -= static_cast<unsigned>(ret);
+                    return 0;
+                }
+                if (errno != EINTR)
+                    return -errno;
+            }
+        }
+
+        // takes back the entries queued since the last successful submit, which the kernel
+        // has not seen, and calls on_fail(op) for each; returns how many there were
+        template <typename F>
+        unsigned drop_queued(F &&on_fail)
+        {
+            const unsigned tail = *sq_tail, n = queued;
+            std::vector<read_op *> dropped;
+            for (unsigned i = n; i > 0; --i)
+            {
+                const io_uring_sqe &sqe = sqes[(tail - i) & *sq_mask];
+                dropped.push_back(reinterpret_cast<read_op *>(sqe.user_data));
+            }
+            store_release(sq_tail, tail - n);
+            queued = 0;
+            for (read_op *op : dropped)
+                on_fail(op);
+            return n;
+        }
+
+        template <typename F>
+        void reap(F &&on_complete)
+        {
+            unsigned head = *cq_head;
+            const unsigned tail = load_acquire(cq_tail);
+            for (; head != tail; ++head)
+            {
+                const io_uring_cqe &cqe = cqes[head & *cq_mask];
+                auto *op = reinterpret_cast<read_op *>(cqe.user_data);
+                op->result = cqe.res;
+                on_complete(op);
+            }
+            store_release(cq_head, head);
+        }
+    };
+
+    // the same queue-and-reap interface served by blocking pread() on worker threads
+    class pread_pool
+    {
+        std::mutex m;
+        std::condition_variable work_ready, done_ready;
+        std::deque<read_op *> work;
+        std::vector<read_op *> done;
+        bool stopping = false;
+        std::vector<std::thread> threads;
+
+        void worker()
+        {
+            for (;;)
+            {
+                read_op *op;
+                {
+                    std::unique_lock<std::mutex> lk(m);
+                    work_ready.wait(lk, [this]
+                                    { return stopping || !work.empty(); });
+                    if (work.empty())
+                        return;
+                    op = work.front();
+                    work.pop_front();
+                }
+                ssize_t n = ::pread(op->fd, op->buf, op->len, static_cast<off_t>(op->offset));
+                op->result = n >= 0 ? n : -errno;
+                {
+                    std::lock_guard<std::mutex> lk(m);
+                    done.push_back(op);
+                }
+                done_ready.notify_one();
+            }
+        }
+
+    public:
+        explicit pread_pool(unsigned n)
+        {
+            for (unsigned i = 0; i < n; ++i)
+                threads.emplace_back([this]
+                                     { worker(); });
+        }
+        ~pread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lk(m);
+                stopping = true;
+            }
+            work_ready.notify_all();
+            for (auto &t : threads)
+                t.join();
+        }
+
+        void queue_read(read_op *op)
+        {
+            {
+                std::lock_guard<std::mutex> lk(m);
+                work.push_back(op);
+            }
+            work_ready.notify_one();
+        }
+
+        template <typename F>
+        void wait_and_reap(F &&on_complete)
+        {
+            std::vector<read_op *> batch;
+            {
+                std::unique_lock<std::mutex> lk(m);
+                done_ready.wait(lk, [this]
+                                { return !done.empty(); });
+                batch.swap(done);
+            }
+            for (read_op *op : batch)
+                on_complete(op);
+        }
+    };
+}
+
+//////////////////
+// Async reader //
+//////////////////
+
+class async_reader
+{
+public:
+    struct options
+    {
+        unsigned queue_depth = 64;
+        std::size_t registered_buffer_size = 0; // per slot; 0 = no registered buffers
+        bool force_fallback = false;            // skip io_uring even if available
+        unsigned fallback_threads = 4;
+    };
+
+    class read_awaitable
+    {
+        async_reader &reader;
+        async_file_detail::read_op op;
+
+    public:
+        read_awaitable(async_reader &reader, async_file_detail::read_op op)
+            : reader(reader), op(op) {}
+        bool await_ready() const { return false; }
+        void await_suspend(std::coroutine_handle<> h)
+        {
+            op.waiter = h;
+            reader.start(&op);
+        }
+        int64_t await_resume() const { return op.result; }
+    };
+
+private:
+    using read_op = async_file_detail::read_op;
+
+    options opts;
+    // declared first so it is destroyed last: the ring is closed, which drops the buffer
+    // registration, and the pool's workers are joined before any buffer is freed
+    std::vector<std::unique_ptr<std::byte, async_file_detail::free_deleter>> buffers;
+    async_file_detail::uring ring;
+    std::unique_ptr<async_file_detail::pread_pool> pool;
+    bool buffers_registered = false;
+    std::deque<read_op *> waiting; // over the queue depth
+    unsigned in_flight = 0;
+
+    void issue(read_op *op)
+    {
+        ++in_flight;
+        if (pool)
+            pool->queue_read(op);
+        else
+            ring.queue_read(op, op->buf_index >= 0 && buffers_registered);
+    }
+
+    void start(read_op *op)
+    {
+        if (in_flight < opts.queue_depth)
+            issue(op);
+        else
+            waiting.push_back(op);
+    }
+
+    void complete(read_op *op)
+    {
+        --in_flight;
+        if (!waiting.empty())
+        {
+            issue(waiting.front());
+            waiting.pop_front();
+        }
+        op->waiter.resume();
+    }
+
+public:
+    explicit async_reader(const options &o) : opts(o)
+    {
+        if (opts.queue_depth == 0)
+            opts.queue_depth = 1;
+        if (opts.force_fallback || !ring.open(opts.queue_depth))
+            pool = std::make_unique<async_file_detail::pread_pool>(
+                std::max(1u, std::min(opts.fallback_threads, opts.queue_depth)));
+        if (opts.registered_buffer_size > 0)
+        {
+            const std::size_t page = 4096;
+            std::size_t size = (opts.registered_buffer_size + page - 1) / page * page;
+            std::vector<iovec> iovs;
+            for (unsigned i = 0; i < opts.queue_depth; ++i)
+            {
+                buffers.emplace_back(static_cast<std::byte *>(std::aligned_alloc(page, size)));
+                if (!buffers.back())
+                    throw std::bad_alloc(); // the buffers allocated so far are freed
+                iovs.push_back(iovec{buffers.back().get(), opts.registered_buffer_size});
+            }
+            // registration can fail (e.g. RLIMIT_MEMLOCK); plain reads into the same buffers
+            // still work then
+            buffers_registered = !pool && ring.register_buffers(iovs.data(), opts.queue_depth);
+        }
+    }
+    async_reader() : async_reader(options{}) {}
+    async_reader(const async_reader &) = delete;
+    async_reader &operator=(const async_reader &) = delete;
+
+    bool uses_io_uring() const { return !pool; }
+    bool uses_registered_buffers() const { return buffers_registered; }
+    unsigned queue_depth() const { return opts.queue_depth; }
+
+    // registered buffer `i`, one per queue slot
+    std::span<std::byte> buffer(unsigned i)
+    {
+        return {buffers[i].get(), opts.registered_buffer_size};
+    }
+
+    static constexpr std::size_t max_read_size = async_file_detail::max_read_size;
+
+    // reads up to min(buf.size(), max_read_size) bytes
+    read_awaitable read(int fd, std::span<std::byte> buf, uint64_t offset)
+    {
+        std::size_t len = std::min(buf.size(), max_read_size);
+        return read_awaitable(*this, read_op{fd, buf.data(), static_cast<uint32_t>(len),
+                                             offset, -1, 0, {}});
+    }
+
+    // reads up to `len` bytes into registered buffer `i`
+    read_awaitable read_fixed(int fd, unsigned i, std::size_t len, uint64_t offset)
+    {
+        len = std::min({len, opts.registered_buffer_size, max_read_size});
+        return read_awaitable(*this, read_op{fd, buffers[i].get(), static_cast<uint32_t>(len),
+                                             offset, static_cast<int>(i), 0, {}});
+    }
+
+    // drives submissions and completions until no read is queued or in flight
+    void run()
+    {
+        auto on_complete = [this](read_op *op)
+        { complete(op); };
+        while (in_flight > 0)
+        {
+            if (pool)
+                pool->wait_and_reap(on_complete);
+            else
+            {
+                // EAGAIN / EBUSY: the kernel is short of resources or the completion queue is
+                // full; reaping what has completed makes room for the next attempt. Any other
+                // error fails the reads that were to be submitted, with that -errno, and is
+                // only thrown if there were none, as nothing else could end the wait
+                int err = ring.submit_and_wait();
+                if (err < 0 && err != -EAGAIN && err != -EBUSY &&
+                    ring.drop_queued([&](read_op *op)
+                                     { op->result = err; complete(op); }) == 0)
+                    throw std::system_error(-err, std::generic_category(), "io_uring_enter");
+                ring.reap(on_complete);
+            }
+        }
+    }
+};
+
+#endif
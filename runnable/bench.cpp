@@ -0,0 +1,1249 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <random>
+#include <variant>
+#include <functional>
+#include <string_view>
+#include <charconv>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <complex>
+#include <algorithm>
+#include <array>
+#include <execution>
+#include <span>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <set>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <syncstream>
+#include "utils.hpp"
+#include "fast_visit.hpp"
+#include "function_ref.hpp"
+#include "sv_utils.hpp"
+#include "parse_int.hpp"
+#include "format_number.hpp"
+#include "complex_array.hpp"
+#include "dispatch_algos.hpp"
+#include "lookup_tables.hpp"
+#include "static_sort.hpp"
+#include "parallel_sort.hpp"
+#include "inline_string.hpp"
+#include "soa_vector.hpp"
+#include "ring_buffer.hpp"
+#include "rw_locks.hpp"
+#include "reclamation.hpp"
+#include "dir_walker.hpp"
+#include "mapped_file.hpp"
+#include "async_file.hpp"
+#include "chunk_generator.hpp"
+
+// Micro-benchmarks for the performance-oriented helpers next to the runnables. Numbers are
+// only meaningful relative to each other within a single run on the same machine.
+
+static constexpr size_t BENCH_OPS = 1'000'000;
+
+////////////////////////////////
+// Variant & virtual dispatch //
+////////////////////////////////
+
+struct MsgObj
+{
+    int x;
+    int y;
+};
+
+using Msg = std::variant<int, double, MsgObj, std::string>;
+
+struct MsgVisitor
+{
+    long operator()(int x) const { return x; }
+    long operator()(double d) const { return static_cast<long>(d); }
+    long operator()(const MsgObj &o) const { return o.x + o.y; }
+    long operator()(const std::string &s) const { return static_cast<long>(s.size()); }
+};
+
+// virtual dispatch counterpart in the style of ObjD/ObjE from cpp11.cpp
+struct MsgBase
+{
+    virtual ~MsgBase() = default;
+    virtual long foo() const = 0;
+};
+
+struct MsgInt : MsgBase
+{
+    int x;
+    explicit MsgInt(int x) : x(x) {}
+    long foo() const override { return x; }
+};
+
+struct MsgDouble : MsgBase
+{
+    double d;
+    explicit MsgDouble(double d) : d(d) {}
+    long foo() const override { return static_cast<long>(d); }
+};
+
+struct MsgPair : MsgBase
+{
+    MsgObj o;
+    explicit MsgPair(MsgObj o) : o(o) {}
+    long foo() const override { return o.x + o.y; }
+};
+
+struct MsgString : MsgBase
+{
+    std::string s;
+    explicit MsgString(std::string s) : s(std::move(s)) {}
+    long foo() const override { return static_cast<long>(s.size()); }
+};
+
+void bench_variant_dispatch()
+{
+    std::mt19937 rng(42);
+    std::vector<Msg> msgs;
+    std::vector<std::unique_ptr<MsgBase>> objs;
+    msgs.reserve(BENCH_OPS);
+    objs.reserve(BENCH_OPS);
+    for (size_t i = 0; i < BENCH_OPS; ++i)
+    {
+        switch (rng() % 4)
+        {
+        case 0:
+            msgs.emplace_back(static_cast<int>(i));
+            objs.push_back(std::make_unique<MsgInt>(static_cast<int>(i)));
+            break;
+        case 1:
+            msgs.emplace_back(1.5 * i);
+            objs.push_back(std::make_unique<MsgDouble>(1.5 * i));
+            break;
+        case 2:
+            msgs.emplace_back(MsgObj{1, 2});
+            objs.push_back(std::make_unique<MsgPair>(MsgObj{1, 2}));
+            break;
+        default:
+            msgs.emplace_back(std::string("msg"));
+            objs.push_back(std::make_unique<MsgString>("msg"));
+            break;
+        }
+    }
+    print_bench("std::visit", time_ns_per_op(BENCH_OPS, [&]
+                                             {
+        long sum = 0;
+        for (const auto &m : msgs)
+            sum += std::visit(MsgVisitor{}, m);
+        do_not_optimize(sum); }));
+    print_bench("fast_visit", time_ns_per_op(BENCH_OPS, [&]
+                                             {
+        long sum = 0;
+        for (const auto &m : msgs)
+            sum += fast_visit(MsgVisitor{}, m);
+        do_not_optimize(sum); }));
+    print_bench("virtual dispatch", time_ns_per_op(BENCH_OPS, [&]
+                                                   {
+        long sum = 0;
+        for (const auto &o : objs)
+            sum += o->foo();
+        do_not_optimize(sum); }));
+    auto mul = [](auto x, auto y) -> double
+    { return x * y; };
+    std::vector<std::variant<int, double>> nums;
+    for (size_t i = 0; i < BENCH_OPS; ++i)
+        nums.emplace_back(rng() % 2 ? std::variant<int, double>(1) : std::variant<int, double>(0.5));
+    print_bench("std::visit (2 variants)", time_ns_per_op(BENCH_OPS - 1, [&]
+                                                          {
+        double sum = 0;
+        for (size_t i = 0; i + 1 < nums.size(); ++i)
+            sum += std::visit(mul, nums[i], nums[i + 1]);
+        do_not_optimize(sum); }));
+    print_bench("fast_visit (2 variants)", time_ns_per_op(BENCH_OPS - 1, [&]
+                                                          {
+        double sum = 0;
+        for (size_t i = 0; i + 1 < nums.size(); ++i)
+            sum += fast_visit(mul, nums[i], nums[i + 1]);
+        do_not_optimize(sum); }));
+}
+
+///////////////////////////
+// Type-erased callbacks //
+///////////////////////////
+
+template <typename Callback>
+[[gnu::noinline]] long run_callback(Callback &&cb, long i)
+{
+    return cb(i);
+}
+
+void bench_callbacks()
+{
+    // captures 32 bytes -- larger than the small-buffer of common std::function implementations
+    long a = 1, b = 2, c = 3, d = 4;
+    auto make_lambda = [&](long i)
+    { return [a, b, c, i](long x)
+      { return x * a + b - c + i; }; };
+    print_bench("direct lambda", time_ns_per_op(BENCH_OPS, [&]
+                                                {
+        long sum = 0;
+        for (size_t i = 0; i < BENCH_OPS; ++i)
+            sum += run_callback(make_lambda(i), d);
+        do_not_optimize(sum); }));
+    print_bench("function_ref", time_ns_per_op(BENCH_OPS, [&]
+                                               {
+        long sum = 0;
+        for (size_t i = 0; i < BENCH_OPS; ++i)
+        {
+            auto l = make_lambda(i);
+            sum += run_callback(function_ref<long(long)>(l), d);
+        }
+        do_not_optimize(sum); }));
+    print_bench("inplace_function<32>", time_ns_per_op(BENCH_OPS, [&]
+                                                       {
+        long sum = 0;
+        for (size_t i = 0; i < BENCH_OPS; ++i)
+            sum += run_callback(inplace_function<long(long), 32>(make_lambda(i)), d);
+        do_not_optimize(sum); }));
+    print_bench("std::function", time_ns_per_op(BENCH_OPS, [&]
+                                                {
+        long sum = 0;
+        for (size_t i = 0; i < BENCH_OPS; ++i)
+            sum += run_callback(std::function<long(long)>(make_lambda(i)), d);
+        do_not_optimize(sum); }));
+}
+
+//////////////////////////
+// string_view scanning //
+//////////////////////////
+
+void bench_string_view_scan()
+{
+    // a synthetic log with lines of 40-200 bytes and some indentation; ops are bytes scanned
+    std::mt19937 rng(7);
+    std::string log;
+    while (log.size() < 64 * BENCH_OPS)
+    {
+        log.append(rng() % 8, ' ');
+        log.append(40 + rng() % 160, 'x');
+        log += '\n';
+    }
+    std::string_view view(log);
+    print_bench("lines: string_view::find (per byte)", time_ns_per_op(log.size(), [&]
+                                                                      {
+        size_t n = 0, pos = 0;
+        while (pos < view.size())
+        {
+            size_t nl = view.find('\n', pos);
+            if (nl == std::string_view::npos)
+                nl = view.size();
+            n += nl - pos;
+            pos = nl + 1;
+        }
+        do_not_optimize(n); }));
+    print_bench("lines: sv_utils lines (per byte)", time_ns_per_op(log.size(), [&]
+                                                                   {
+        size_t n = 0;
+        for (auto line : lines(view))
+            n += line.size();
+        do_not_optimize(n); }));
+    std::string padded = std::string(4096, ' ') + "x" + std::string(4096, ' ');
+    std::string_view pv(padded);
+    print_bench("trim: find_first/last_not_of (per byte)", time_ns_per_op(padded.size() * 1000, [&]
+                                                                          {
+        for (int i = 0; i < 1000; ++i)
+        {
+            auto t = pv.substr(pv.find_first_not_of(" \t\n\v\f\r"));
+            t = t.substr(0, t.find_last_not_of(" \t\n\v\f\r") + 1);
+            do_not_optimize(t);
+        } }));
+    print_bench("trim: sv_utils trim (per byte)", time_ns_per_op(padded.size() * 1000, [&]
+                                                                 {
+        for (int i = 0; i < 1000; ++i)
+        {
+            auto t = trim(pv);
+            do_not_optimize(t);
+        } }));
+}
+
+/////////////////////
+// Integer parsing //
+/////////////////////
+
+void bench_parse_int()
+{
+    std::mt19937_64 rng(29);
+    std::vector<std::string> nums;
+    nums.reserve(BENCH_OPS);
+    for (size_t i = 0; i < BENCH_OPS; ++i)
+        nums.push_back(std::to_string(static_cast<int64_t>(rng() >> (rng() % 64)) - (1 << 20)));
+    print_bench("std::stoll", time_ns_per_op(BENCH_OPS, [&]
+                                             {
+        long long sum = 0;
+        for (const auto &n : nums)
+            sum += std::stoll(n);
+        do_not_optimize(sum); }));
+    print_bench("std::strtoll", time_ns_per_op(BENCH_OPS, [&]
+                                               {
+        long long sum = 0;
+        for (const auto &n : nums)
+            sum += std::strtoll(n.c_str(), nullptr, 10);
+        do_not_optimize(sum); }));
+    print_bench("std::from_chars", time_ns_per_op(BENCH_OPS, [&]
+                                                  {
+        long long sum = 0;
+        for (const auto &n : nums)
+        {
+            long long v = 0;
+            std::from_chars(n.data(), n.data() + n.size(), v);
+            sum += v;
+        }
+        do_not_optimize(sum); }));
+    print_bench("parse_int (SWAR)", time_ns_per_op(BENCH_OPS, [&]
+                                                   {
+        long long sum = 0;
+        for (const auto &n : nums)
+            sum += parse_int<long long>(n).value_or(0);
+        do_not_optimize(sum); }));
+}
+
+///////////////////////
+// Number formatting //
+///////////////////////
+
+void bench_format_number()
+{
+    // doubles spread over many magnitudes and integers of mixed widths, the kind of values a
+    // serializer writes out; ops are numbers formatted
+    std::mt19937_64 rng(46);
+    std::uniform_real_distribution<double> mantissa(1, 10);
+    std::vector<double> reals(BENCH_OPS);
+    for (auto &v : reals)
+        v = mantissa(rng) * std::pow(10.0, static_cast<int>(rng() % 20) - 10);
+    std::vector<int64_t> ints(BENCH_OPS);
+    for (auto &v : ints)
+        v = static_cast<int64_t>(rng() >> (rng() % 64)) - (1 << 20);
+
+    print_bench("double, std::to_string", time_ns_per_op(BENCH_OPS, [&]
+                                                         {
+        size_t total = 0;
+        for (double v : reals)
+            total += std::to_string(v).size();
+        do_not_optimize(total); }));
+    print_bench("double, snprintf %.17g", time_ns_per_op(BENCH_OPS, [&]
+                                                         {
+        size_t total = 0;
+        char buf[32];
+        for (double v : reals)
+            total += std::snprintf(buf, sizeof(buf), "%.17g", v);
+        do_not_optimize(total); }));
+    print_bench("double, format_number (shortest)", time_ns_per_op(BENCH_OPS, [&]
+                                                                   {
+        size_t total = 0;
+        char buf[max_chars<double>];
+        for (double v : reals)
+            total += format_number(buf, buf + sizeof(buf), v) - buf;
+        do_not_optimize(total); }));
+    print_bench("int64, std::to_string", time_ns_per_op(BENCH_OPS, [&]
+                                                        {
+        size_t total = 0;
+        for (int64_t v : ints)
+            total += std::to_string(v).size();
+        do_not_optimize(total); }));
+    print_bench("int64, snprintf %lld", time_ns_per_op(BENCH_OPS, [&]
+                                                       {
+        size_t total = 0;
+        char buf[32];
+        for (int64_t v : ints)
+            total += std::snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(v));
+        do_not_optimize(total); }));
+    print_bench("int64, format_number", time_ns_per_op(BENCH_OPS, [&]
+                                                       {
+        size_t total = 0;
+        char buf[max_chars<int64_t>];
+        for (int64_t v : ints)
+            total += format_number(buf, buf + sizeof(buf), v) - buf;
+        do_not_optimize(total); }));
+}
+
+////////////////////
+// Complex arrays //
+////////////////////
+
+template <complex_layout L>
+void bench_complex_layout(const std::string &name, size_t n, size_t rounds)
+{
+    std::mt19937_64 rng(47);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    complex_array<L> a(n), b(n), out(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        a.set(i, dist(rng), dist(rng));
+        b.set(i, dist(rng), dist(rng));
+    }
+    std::vector<double> mags;
+    print_bench(name + ", add", time_ns_per_op(n * rounds, [&]
+                                               {
+        for (size_t r = 0; r < rounds; ++r)
+            complex_kernels::add(a, b, out);
+        do_not_optimize(out.re(n - 1)); }));
+    print_bench(name + ", multiply", time_ns_per_op(n * rounds, [&]
+                                                    {
+        for (size_t r = 0; r < rounds; ++r)
+            complex_kernels::multiply(a, b, out);
+        do_not_optimize(out.re(n - 1)); }));
+    print_bench(name + ", conj", time_ns_per_op(n * rounds, [&]
+                                                {
+        for (size_t r = 0; r < rounds; ++r)
+            complex_kernels::conj(a, out);
+        do_not_optimize(out.im(n - 1)); }));
+    print_bench(name + ", abs", time_ns_per_op(n * rounds, [&]
+                                               {
+        for (size_t r = 0; r < rounds; ++r)
+            complex_kernels::abs(a, mags);
+        do_not_optimize(mags.back()); }));
+    print_bench(name + ", dot", time_ns_per_op(n * rounds, [&]
+                                               {
+        std::complex<double> sum = 0;
+        for (size_t r = 0; r < rounds; ++r)
+            sum += complex_kernels::dot(a, b);
+        do_not_optimize(sum); }));
+}
+
+void bench_complex_arrays()
+{
+    // 4096 samples (128 KiB for the three arrays) stay in L2, so this measures the loops
+    // themselves; ops are complex elements
+    const size_t n = 4096, rounds = BENCH_OPS / n;
+    std::mt19937_64 rng(47);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    std::vector<std::complex<double>> a(n), b(n), out(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        a[i] = {dist(rng), dist(rng)};
+        b[i] = {dist(rng), dist(rng)};
+    }
+    print_bench("std::complex, multiply", time_ns_per_op(n * rounds, [&]
+                                                         {
+        for (size_t r = 0; r < rounds; ++r)
+            for (size_t i = 0; i < n; ++i)
+                out[i] = a[i] * b[i]; // with the C99 Annex G inf/NaN fix-ups
+        do_not_optimize(out.back()); }));
+    bench_complex_layout<complex_layout::interleaved>("interleaved", n, rounds);
+    bench_complex_layout<complex_layout::split>("split", n, rounds);
+    // 2^22 samples (192 MiB for three buffers) stream from memory instead: a multiply reads
+    // 32 bytes and writes 16 per sample, so this is bounded by memory bandwidth
+    const size_t big = 1 << 22;
+    complex_buffer x(big), y(big), z(big);
+    std::ranges::fill(x.real(), 0.5);
+    std::ranges::fill(y.imag(), 2.0);
+    print_bench("complex_buffer multiply, 2^22 samples", time_ns_per_op(big, [&]
+                                                                        {
+        complex_kernels::multiply(x, y, z);
+        do_not_optimize(z.im(big - 1)); }, 3));
+
+    std::vector<double> xs(n);
+    for (auto &x : xs)
+        x = dist(rng);
+    print_bench("std::pow(x, 7)", time_ns_per_op(n * rounds, [&]
+                                                 {
+        double sum = 0;
+        for (size_t r = 0; r < rounds; ++r)
+            for (double x : xs)
+                sum += std::pow(x, 7);
+        do_not_optimize(sum); }));
+    print_bench("ipow<7>(x)", time_ns_per_op(n * rounds, [&]
+                                             {
+        double sum = 0;
+        for (size_t r = 0; r < rounds; ++r)
+            for (double x : xs)
+                sum += ipow<7>(x);
+        do_not_optimize(sum); }));
+}
+
+///////////////////////////////////
+// Concept-dispatched algorithms //
+///////////////////////////////////
+
+template <typename Container>
+void bench_dispatch_on(const std::string &name, Container &src, Container &dst)
+{
+    // the value searched for and counted is absent, so find scans the whole range too
+    namespace d = dispatch_algos_detail;
+    using T = typename Container::value_type;
+    const size_t n = src.size();
+    const T missing = T(-1);
+    print_bench(name + " copy, generic", time_ns_per_op(n, [&]
+                                                        {
+        do_not_optimize(d::generic_copy(src.begin(), src.end(), dst.begin())); }));
+    print_bench(name + " copy, dispatched", time_ns_per_op(n, [&]
+                                                           {
+        do_not_optimize(fast_copy(src.begin(), src.end(), dst.begin())); }));
+    print_bench(name + " fill, generic", time_ns_per_op(n, [&]
+                                                        {
+        d::generic_fill(dst.begin(), dst.end(), T(1));
+        do_not_optimize(dst.back()); }));
+    print_bench(name + " fill, dispatched", time_ns_per_op(n, [&]
+                                                           {
+        fast_fill(dst.begin(), dst.end(), T(1));
+        do_not_optimize(dst.back()); }));
+    print_bench(name + " find, generic", time_ns_per_op(n, [&]
+                                                        {
+        do_not_optimize(d::generic_find(src.begin(), src.end(), missing)); }));
+    print_bench(name + " find, dispatched", time_ns_per_op(n, [&]
+                                                           {
+        do_not_optimize(fast_find(src.begin(), src.end(), missing)); }));
+    print_bench(name + " count, generic", time_ns_per_op(n, [&]
+                                                         {
+        do_not_optimize(d::generic_count(src.begin(), src.end(), missing)); }));
+    print_bench(name + " count, dispatched", time_ns_per_op(n, [&]
+                                                            {
+        do_not_optimize(fast_count(src.begin(), src.end(), missing)); }));
+}
+
+void bench_concept_dispatch()
+{
+    // ops are elements; 1M ints stay within the last-level cache of most machines
+    std::vector<int> ints(BENCH_OPS), ints_out(BENCH_OPS);
+    std::iota(ints.begin(), ints.end(), 0);
+    std::vector<char> chars(BENCH_OPS, 'x'), chars_out(BENCH_OPS);
+    std::deque<int> deq(ints.begin(), ints.end()), deq_out(BENCH_OPS);
+    bench_dispatch_on("vector<int>", ints, ints_out);
+    bench_dispatch_on("vector<char>", chars, chars_out);
+    bench_dispatch_on("deque<int>", deq, deq_out);
+}
+
+/////////////////////////////////
+// Combinatorics lookup tables //
+/////////////////////////////////
+
+[[gnu::noinline]] uint64_t binomial_computed(uint64_t n, uint64_t k)
+{
+    // multiplicative formula; exact since every prefix product is itself a binomial
+    uint64_t r = 1;
+    for (uint64_t i = 1; i <= k; ++i)
+        r = r * (n - k + i) / i;
+    return r;
+}
+
+void bench_lookup_tables()
+{
+    std::mt19937 rng(31);
+    std::vector<std::pair<uint32_t, uint32_t>> queries(BENCH_OPS);
+    for (auto &[n, k] : queries)
+    {
+        n = rng() % 60;
+        k = rng() % (n + 1);
+    }
+    print_bench("binomial: computed", time_ns_per_op(BENCH_OPS, [&]
+                                                     {
+        uint64_t sum = 0;
+        for (auto [n, k] : queries)
+            sum += binomial_computed(n, k);
+        do_not_optimize(sum); }));
+    print_bench("binomial: consteval table", time_ns_per_op(BENCH_OPS, [&]
+                                                            {
+        uint64_t sum = 0;
+        for (auto [n, k] : queries)
+            sum += binomial_lookup(n, k);
+        do_not_optimize(sum); }));
+}
+
+/////////////////////////
+// Small array sorting //
+/////////////////////////
+
+template <std::size_t N>
+void bench_small_sort_n()
+{
+    // ops are whole arrays sorted
+    const size_t count = BENCH_OPS / N * 4;
+    std::mt19937 rng(33);
+    std::vector<std::array<int, N>> arrays(count);
+    for (auto &a : arrays)
+        for (auto &x : a)
+            x = static_cast<int>(rng());
+    auto work = arrays;
+    const std::string n = std::to_string(N);
+    print_bench("std::sort, N = " + n, time_ns_per_op(count, [&]
+                                                      {
+        work = arrays;
+        for (auto &a : work)
+            std::sort(a.begin(), a.end());
+        do_not_optimize(work[0]); }));
+    print_bench("static_sort, N = " + n, time_ns_per_op(count, [&]
+                                                        {
+        work = arrays;
+        for (auto &a : work)
+            static_sort(a);
+        do_not_optimize(work[0]); }));
+}
+
+void bench_small_sort()
+{
+    bench_small_sort_n<3>();
+    bench_small_sort_n<8>();
+    bench_small_sort_n<16>();
+    bench_small_sort_n<32>();
+}
+
+/////////////////////////
+// Large array sorting //
+/////////////////////////
+
+void bench_large_sort()
+{
+    // ops are elements sorted; 1e8+ elements work the same way but need several GB of RAM
+    for (size_t n : {BENCH_OPS, 10 * BENCH_OPS})
+    {
+        std::mt19937_64 rng(34);
+        std::vector<int64_t> keys(n);
+        for (auto &k : keys)
+            k = static_cast<int64_t>(rng());
+        std::vector<int64_t> work;
+        const std::string suffix = ", n = " + std::to_string(n);
+        auto run = [&](const std::string &label, auto &&sort)
+        {
+            print_bench(label + suffix, time_ns_per_op(n, [&]
+                                                       {
+                work = keys;
+                sort(work);
+                do_not_optimize(work[0]); }, 3));
+        };
+        run("std::sort", [](auto &v)
+            { std::sort(v.begin(), v.end()); });
+        run("std::sort(par)", [](auto &v)
+            { std::sort(std::execution::par, v.begin(), v.end()); });
+        run("radix_sort", [](auto &v)
+            { radix_sort(std::span(v)); });
+        run("parallel_merge_sort", [](auto &v)
+            { parallel_merge_sort(std::span(v)); });
+    }
+}
+
+///////////////////////
+// Short string keys //
+///////////////////////
+
+void bench_short_strings()
+{
+    // header-like keys of 12-24 characters, partly beyond the usual 15-char SSO limit
+    std::mt19937 rng(36);
+    std::vector<std::string> sources;
+    for (size_t i = 0; i < 1024; ++i)
+        sources.push_back("x-hdr-" + std::string(6 + rng() % 12, static_cast<char>('a' + i % 26)));
+    auto build = [&](auto tag)
+    {
+        using S = decltype(tag);
+        std::vector<S> keys;
+        keys.reserve(BENCH_OPS);
+        for (size_t i = 0; i < BENCH_OPS; ++i)
+            keys.emplace_back(std::string_view(sources[i % sources.size()]));
+        return keys;
+    };
+    auto run = [&](const std::string &label, auto tag)
+    {
+        using S = decltype(tag);
+        print_bench(label + ": build", time_ns_per_op(BENCH_OPS, [&]
+                                                      { do_not_optimize(build(tag).back()); }, 3));
+        auto keys = build(tag);
+        std::vector<S> copies;
+        print_bench(label + ": copy", time_ns_per_op(BENCH_OPS, [&]
+                                                     {
+            copies = keys;
+            do_not_optimize(copies.back()); }, 3));
+        print_bench(label + ": hash", time_ns_per_op(BENCH_OPS, [&]
+                                                     {
+            size_t h = 0;
+            for (const auto &k : keys)
+                h ^= std::hash<S>{}(k);
+            do_not_optimize(h); }, 3));
+    };
+    run("std::string", std::string());
+    run("inline_string<31>", inline_string<31>());
+}
+
+/////////////////////
+// Column scanning //
+/////////////////////
+
+void bench_column_scan()
+{
+    // records shaped like the tuple<int, const char *, double> profiles of the runnables,
+    // padded with a larger payload field; ops are records scanned
+    using Payload = std::array<char, 40>;
+    std::vector<std::tuple<int, const char *, double, Payload>> aos;
+    soa_vector<int, const char *, double, Payload> soa;
+    for (size_t i = 0; i < 4 * BENCH_OPS; ++i)
+    {
+        aos.emplace_back(static_cast<int>(i), "name", 0.5 * i, Payload{});
+        soa.push_back(static_cast<int>(i), "name", 0.5 * i, Payload{});
+    }
+    print_bench("sum of one field: array of structs", time_ns_per_op(aos.size(), [&]
+                                                                     {
+        double sum = 0;
+        for (const auto &r : aos)
+            sum += std::get<2>(r);
+        do_not_optimize(sum); }));
+    print_bench("sum of one field: soa_vector column", time_ns_per_op(soa.size(), [&]
+                                                                      {
+        double sum = 0;
+        for (double h : soa.column<2>())
+            sum += h;
+        do_not_optimize(sum); }));
+    print_bench("sum of one field: soa_vector rows", time_ns_per_op(soa.size(), [&]
+                                                                    {
+        double sum = 0;
+        for (auto [a, n, h, p] : soa)
+            sum += h;
+        do_not_optimize(sum); }));
+}
+
+////////////////////
+// Thread handoff //
+////////////////////
+
+// the textbook baseline: a vector guarded by a mutex, consumers take whatever is queued
+template <typename T>
+class locked_queue
+{
+    std::mutex m;
+    std::vector<T> items;
+    size_t head = 0;
+
+public:
+    explicit locked_queue(size_t) {}
+
+    bool try_push(T item)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        items.push_back(std::move(item));
+        return true;
+    }
+
+    size_t pop_batch(T *out, size_t max)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        size_t n = std::min(max, items.size() - head);
+        std::copy_n(items.begin() + head, n, out);
+        head += n;
+        if (head == items.size())
+        {
+            items.clear();
+            head = 0;
+        }
+        return n;
+    }
+};
+
+// `threads` producers hand BENCH_OPS ints to `threads` consumers; ops are items handed over
+template <typename Queue>
+double handoff_ns(int threads, size_t batch)
+{
+    return time_ns_per_op(BENCH_OPS, [&]
+                          {
+        Queue q(1024);
+        std::atomic<size_t> received(0);
+        std::vector<std::thread> pool;
+        for (int p = 0; p < threads; ++p)
+            pool.emplace_back([&, p]
+                              {
+                for (size_t i = p; i < BENCH_OPS; i += threads)
+                    while (!q.try_push(static_cast<int>(i)))
+                        std::this_thread::yield(); });
+        for (int c = 0; c < threads; ++c)
+            pool.emplace_back([&]
+                              {
+                int buf[64];
+                long long sum = 0;
+                while (received.load(std::memory_order_relaxed) < BENCH_OPS)
+                {
+                    size_t n = q.pop_batch(buf, batch);
+                    for (size_t k = 0; k < n; ++k)
+                        sum += buf[k];
+                    received.fetch_add(n, std::memory_order_relaxed);
+                    if (n == 0)
+                        std::this_thread::yield();
+                }
+                do_not_optimize(sum); });
+        for (auto &t : pool)
+            t.join(); }, 3);
+}
+
+void bench_thread_handoff()
+{
+    print_bench("1 -> 1: spsc_ring", handoff_ns<spsc_ring<int>>(1, 1));
+    print_bench("1 -> 1: spsc_ring, pop 64", handoff_ns<spsc_ring<int>>(1, 64));
+    for (int threads : {1, 2, 4})
+    {
+        std::string tag = std::to_string(threads) + " -> " + std::to_string(threads) + ": ";
+        print_bench(tag + "mutex + vector", handoff_ns<locked_queue<int>>(threads, 1));
+        print_bench(tag + "mpmc_queue", handoff_ns<mpmc_queue<int>>(threads, 1));
+        print_bench(tag + "mpmc_queue, pop 64", handoff_ns<mpmc_queue<int>>(threads, 64));
+    }
+}
+
+///////////////////////
+// Read-mostly locks //
+///////////////////////
+
+struct BenchConfig
+{
+    long version;
+    long limit;
+    double ratio;
+};
+
+// `threads` threads share BENCH_OPS operations, one in 1024 of them a write; ops are
+// operations completed across all threads
+template <typename Read, typename Write>
+double read_mostly_ns(int threads, Read read, Write write)
+{
+    return time_ns_per_op(BENCH_OPS, [&]
+                          {
+        std::vector<std::thread> pool;
+        for (int t = 0; t < threads; ++t)
+            pool.emplace_back([&]
+                              {
+                long sum = 0;
+                for (size_t i = 0; i < BENCH_OPS / threads; ++i)
+                {
+                    if (i % 1024 == 0)
+                        write(static_cast<long>(i));
+                    else
+                        sum += read();
+                }
+                do_not_optimize(sum); });
+        for (auto &t : pool)
+            t.join(); }, 3);
+}
+
+void bench_read_mostly_locks()
+{
+    BenchConfig plain{0, 0, 0.0};
+    auto set = [](BenchConfig &c, long v)
+    {
+        c.version = v;
+        c.limit = 2 * v;
+        c.ratio = v / 2.0;
+    };
+    std::mutex m;
+    std::shared_mutex sm;
+    distributed_rw_lock drw;
+    seqlock<BenchConfig> sl(plain);
+    for (int threads : {1, 2, 4})
+    {
+        std::string tag = std::to_string(threads) + " thread(s): ";
+        auto mutex_read = [&]
+        {
+            std::lock_guard<std::mutex> lk(m);
+            return plain.limit;
+        };
+        auto mutex_write = [&](long v)
+        {
+            std::lock_guard<std::mutex> lk(m);
+            set(plain, v);
+        };
+        auto shared_read = [&]
+        {
+            std::shared_lock lk(sm);
+            return plain.limit;
+        };
+        auto shared_write = [&](long v)
+        {
+            std::unique_lock lk(sm);
+            set(plain, v);
+        };
+        auto drw_read = [&]
+        {
+            std::shared_lock lk(drw);
+            return plain.limit;
+        };
+        auto drw_write = [&](long v)
+        {
+            std::unique_lock lk(drw);
+            set(plain, v);
+        };
+        auto seq_read = [&]
+        { return sl.load().limit; };
+        auto seq_write = [&](long v)
+        { sl.update([&](BenchConfig &c)
+                    { set(c, v); }); };
+        print_bench(tag + "std::mutex", read_mostly_ns(threads, mutex_read, mutex_write));
+        print_bench(tag + "std::shared_mutex", read_mostly_ns(threads, shared_read, shared_write));
+        print_bench(tag + "distributed_rw_lock", read_mostly_ns(threads, drw_read, drw_write));
+        print_bench(tag + "seqlock", read_mostly_ns(threads, seq_read, seq_write));
+    }
+}
+
+////////////////////////
+// Memory reclamation //
+////////////////////////
+
+template <typename Domain>
+void bench_reclamation_domain(const std::string &name)
+{
+    Domain domain;
+    // read side: lookups in a 64-key list, no writers; ops are lookups
+    lock_free_list<int, Domain> list(domain);
+    for (int k = 0; k < 128; k += 2)
+        list.insert(k);
+    print_bench("list lookup, 64 keys: " + name, time_ns_per_op(BENCH_OPS / 10, [&]
+                                                                {
+        int found = 0;
+        for (size_t i = 0; i < BENCH_OPS / 10; ++i)
+            found += list.contains(static_cast<int>(i & 127));
+        do_not_optimize(found); }));
+    // two threads churning a stack; ops are push + pop pairs
+    lock_free_stack<int, Domain> stack(domain);
+    print_bench("stack push + pop, 2 threads: " + name, time_ns_per_op(BENCH_OPS, [&]
+                                                                       {
+        std::vector<std::thread> pool;
+        for (int t = 0; t < 2; ++t)
+            pool.emplace_back([&]
+                              {
+                for (size_t i = 0; i < BENCH_OPS / 2; ++i)
+                {
+                    stack.push(static_cast<int>(i));
+                    do_not_optimize(stack.pop());
+                } });
+        for (auto &t : pool)
+            t.join(); }, 3));
+    // latency: how long until a node retired by an idle domain is actually freed
+    print_bench("retire until freed: " + name, time_ns_per_op(BENCH_OPS / 10, [&]
+                                                              {
+        for (size_t i = 0; i < BENCH_OPS / 10; ++i)
+        {
+            domain.retire(new int(0));
+            while (domain.reclaim() == 0)
+                ;
+        } }));
+}
+
+void bench_memory_reclamation()
+{
+    bench_reclamation_domain<ebr_domain>("ebr");
+    bench_reclamation_domain<hazard_domain>("hazard");
+
+    std::mutex m;
+    std::set<int> keys;
+    for (int k = 0; k < 128; k += 2)
+        keys.insert(k);
+    print_bench("list lookup, 64 keys: mutex + std::set", time_ns_per_op(BENCH_OPS / 10, [&]
+                                                                          {
+        int found = 0;
+        for (size_t i = 0; i < BENCH_OPS / 10; ++i)
+        {
+            std::lock_guard<std::mutex> lk(m);
+            found += keys.count(static_cast<int>(i & 127));
+        }
+        do_not_optimize(found); }));
+    std::vector<int> stack;
+    print_bench("stack push + pop, 2 threads: mutex", time_ns_per_op(BENCH_OPS, [&]
+                                                                     {
+        std::vector<std::thread> pool;
+        for (int t = 0; t < 2; ++t)
+            pool.emplace_back([&]
+                              {
+                for (size_t i = 0; i < BENCH_OPS / 2; ++i)
+                {
+                    std::lock_guard<std::mutex> lk(m);
+                    stack.push_back(static_cast<int>(i));
+                    do_not_optimize(stack.back());
+                    stack.pop_back();
+                } });
+        for (auto &t : pool)
+            t.join(); }, 3));
+}
+
+///////////////////////
+// Directory walking //
+///////////////////////
+
+void bench_directory_walk()
+{
+    // 20 x 20 directories of 50 small files each; a stand-in for the million-file trees of
+    // the real indexer, scaled down to fit a sandbox. ops are entries listed
+    namespace fs = std::filesystem;
+    fs::path root = fs::temp_directory_path() / ("bench_walk_" + std::to_string(::getpid()));
+    fs::remove_all(root);
+    for (int a = 0; a < 20; ++a)
+        for (int b = 0; b < 20; ++b)
+        {
+            fs::path dir = root / std::to_string(a) / std::to_string(b);
+            fs::create_directories(dir);
+            for (int f = 0; f < 50; ++f)
+                std::ofstream(dir / ("file" + std::to_string(f))) << f;
+        }
+    const size_t entries = 20 + 20 * 20 + 20 * 20 * 50;
+
+    print_bench("recursive_directory_iterator", time_ns_per_op(entries, [&]
+                                                               {
+        size_t n = 0;
+        for (const auto &e : fs::recursive_directory_iterator(root))
+            n += e.is_regular_file();
+        do_not_optimize(n); }, 3));
+    print_bench("recursive_directory_iterator + size", time_ns_per_op(entries, [&]
+                                                                      {
+        uintmax_t bytes = 0;
+        for (const auto &e : fs::recursive_directory_iterator(root))
+            if (e.is_regular_file())
+                bytes += e.file_size();
+        do_not_optimize(bytes); }, 3));
+    for (unsigned threads : {1u, 4u})
+        for (bool stat : {false, true})
+        {
+            walk_options options;
+            options.threads = threads;
+            options.stat = stat;
+            std::string label = "parallel_walk, " + std::to_string(threads) + " thread(s)";
+            print_bench(label + (stat ? " + size" : ""), time_ns_per_op(entries, [&]
+                                                                         {
+                std::atomic<uint64_t> bytes(0);
+                parallel_walk(root, [&](const walk_entry &e)
+                              { bytes.fetch_add(e.size, std::memory_order_relaxed); }, options);
+                do_not_optimize(bytes); }, 3));
+        }
+    fs::remove_all(root);
+}
+
+//////////////////
+// File reading //
+//////////////////
+
+void bench_file_reading()
+{
+    // a 64 MiB text file, read whole and scanned for line breaks; ops are lines
+    namespace fs = std::filesystem;
+    fs::path path = fs::temp_directory_path() / ("bench_mapped_" + std::to_string(::getpid()));
+    const std::string line = std::string(63, 'x') + '\n';
+    const size_t lines = (64u << 20) / line.size();
+    {
+        std::ofstream out(path, std::ios::binary);
+        for (size_t i = 0; i < lines; ++i)
+            out << line;
+    }
+    auto count_lines = [](std::string_view data)
+    { return std::count(data.begin(), data.end(), '\n'); };
+
+    print_bench("ifstream into std::string", time_ns_per_op(lines, [&]
+                                                            {
+        std::ifstream in(path, std::ios::binary);
+        std::ostringstream buf;
+        buf << in.rdbuf();
+        do_not_optimize(count_lines(buf.str())); }, 3));
+    print_bench("ifstream::read into a buffer", time_ns_per_op(lines, [&]
+                                                       {
+        std::string buf(fs::file_size(path), '\0');
+        std::ifstream in(path, std::ios::binary);
+        in.read(buf.data(), buf.size());
+        do_not_optimize(count_lines(buf)); }, 3));
+    print_bench("mapped_file, lazy", time_ns_per_op(lines, [&]
+                                                    {
+        mapped_file file(path);
+        do_not_optimize(count_lines(file.view())); }, 3));
+    print_bench("mapped_file, sequential + willneed", time_ns_per_op(lines, [&]
+                                                                     {
+        mapped_file file(path, {.pattern = mapped_file::access::sequential, .willneed = true});
+        do_not_optimize(count_lines(file.view())); }, 3));
+    print_bench("mapped_file, populate", time_ns_per_op(lines, [&]
+                                                        {
+        mapped_file file(path, {.populate = true});
+        do_not_optimize(count_lines(file.view())); }, 3));
+    fs::remove(path);
+}
+
+/////////////////
+// Async reads //
+/////////////////
+
+// each worker coroutine keeps one read in flight, taking the next offset from a shared list
+io_task bench_read_worker(async_reader &reader, int fd, unsigned slot, bool fixed,
+                          const std::vector<uint64_t> &offsets, size_t &next, size_t block)
+{
+    std::vector<std::byte> buf(block);
+    while (next < offsets.size())
+    {
+        uint64_t off = offsets[next++];
+        int64_t n = fixed ? co_await reader.read_fixed(fd, slot, block, off)
+                          : co_await reader.read(fd, buf, off);
+        do_not_optimize(n);
+    }
+}
+
+void bench_async_reads()
+{
+    // random 4 KiB reads from a 64 MiB file; a local file in the page cache, so this measures
+    // per-read overhead rather than device latency. ops are reads
+    namespace fs = std::filesystem;
+    fs::path path = fs::temp_directory_path() / ("bench_async_" + std::to_string(::getpid()));
+    const size_t block = 4096, file_size = 64u << 20;
+    {
+        std::ofstream out(path, std::ios::binary);
+        std::string chunk(1 << 20, 'x');
+        for (size_t i = 0; i < file_size / chunk.size(); ++i)
+            out << chunk;
+    }
+    std::mt19937_64 rng(44);
+    std::vector<uint64_t> offsets(BENCH_OPS / 16);
+    for (auto &o : offsets)
+        o = rng() % (file_size / block) * block;
+    int fd = ::open(path.c_str(), O_RDONLY);
+
+    print_bench("blocking pread", time_ns_per_op(offsets.size(), [&]
+                                                 {
+        std::vector<std::byte> buf(block);
+        for (uint64_t off : offsets)
+            do_not_optimize(::pread(fd, buf.data(), block, off)); }, 3));
+    auto run = [&](unsigned qd, bool fixed, bool fallback)
+    {
+        return time_ns_per_op(offsets.size(), [&]
+                              {
+            async_reader reader({.queue_depth = qd,
+                                 .registered_buffer_size = fixed ? block : 0,
+                                 .force_fallback = fallback});
+            size_t next = 0;
+            std::vector<io_task> workers;
+            for (unsigned w = 0; w < qd; ++w)
+                workers.push_back(bench_read_worker(reader, fd, w, fixed, offsets, next, block));
+            reader.run(); }, 3);
+    };
+    for (unsigned qd : {1u, 4u, 16u, 64u, 256u})
+        print_bench("io_uring, QD " + std::to_string(qd), run(qd, false, false));
+    print_bench("io_uring + registered buffers, QD 64", run(64, true, false));
+    for (unsigned qd : {1u, 16u, 256u})
+        print_bench("pread thread pool, QD " + std::to_string(qd), run(qd, false, true));
+    ::close(fd);
+    fs::remove(path);
+}
+
+///////////////////////
+// Chunked generator //
+///////////////////////
+
+chunk_generator<uint32_t> bench_numbers(chunk_size, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; ++i)
+        co_yield i * 2654435761u; // a cheap stand-in for decoding one value
+}
+
+// the same values decoded a block at a time and yielded whole
+chunk_generator<uint32_t> bench_number_blocks(uint32_t n)
+{
+    std::array<uint32_t, 4096> block;
+    for (uint32_t i = 0; i < n; i += block.size())
+    {
+        uint32_t len = std::min<uint32_t>(block.size(), n - i);
+        for (uint32_t k = 0; k < len; ++k)
+            block[k] = (i + k) * 2654435761u;
+        co_yield std::span<const uint32_t>(block.data(), len);
+    }
+}
+
+void bench_chunked_generator()
+{
+    // ops are elements produced and summed; chunk size 1 resumes the coroutine for every
+    // element, like the per-element Generator in cpp20.cpp
+    const uint32_t n = 4 * BENCH_OPS;
+    print_bench("plain loop", time_ns_per_op(n, [&]
+                                             {
+        uint32_t sum = 0;
+        for (uint32_t i = 0; i < n; ++i)
+            sum += i * 2654435761u;
+        do_not_optimize(sum); }));
+    for (size_t size : {1, 16, 256, 4096})
+    {
+        std::string label = "chunk size " + std::to_string(size);
+        print_bench(label + ", spans", time_ns_per_op(n, [&]
+                                                      {
+            uint32_t sum = 0;
+            for (std::span<const uint32_t> chunk : bench_numbers(chunk_size{size}, n))
+                for (uint32_t v : chunk)
+                    sum += v;
+            do_not_optimize(sum); }));
+        print_bench(label + ", flatten()", time_ns_per_op(n, [&]
+                                                          {
+            uint32_t sum = 0;
+            auto gen = bench_numbers(chunk_size{size}, n);
+            for (uint32_t v : flatten(gen))
+                sum += v;
+            do_not_optimize(sum); }));
+    }
+    print_bench("4096-element blocks, co_yield span", time_ns_per_op(n, [&]
+                                                                     {
+        uint32_t sum = 0;
+        for (std::span<const uint32_t> chunk : bench_number_blocks(n))
+            for (uint32_t v : chunk)
+                sum += v;
+        do_not_optimize(sum); }));
+}
+
+/////////////////////
+// Harness logging //
+/////////////////////
+
+void bench_harness_logging()
+{
+    // one short result line per op, written to /dev/null so only the formatting and the
+    // per-line hand-off to the OS are measured
+    const size_t lines = BENCH_OPS / 10;
+    print_bench("ofstream, std::endl per line", time_ns_per_op(lines, [&]
+                                                               {
+        std::ofstream out("/dev/null");
+        for (size_t i = 0; i < lines; ++i)
+            out << "  bench_case_" << i << ": " << std::fixed << std::setprecision(3) << 1.5 * i
+                << " ns/op" << std::endl; }));
+    print_bench("ofstream + osyncstream per line", time_ns_per_op(lines, [&]
+                                                                  {
+        std::ofstream out("/dev/null");
+        for (size_t i = 0; i < lines; ++i)
+            std::osyncstream(out) << "  bench_case_" << i << ": " << std::fixed
+                                  << std::setprecision(3) << 1.5 * i << " ns/op\n"; }));
+    print_bench("log_line into a log_sink", time_ns_per_op(lines, [&]
+                                                           {
+        int fd = ::open("/dev/null", O_WRONLY);
+        {
+            log_sink sink(fd);
+            char num[32];
+            for (size_t i = 0; i < lines; ++i)
+            {
+                log_line line(sink);
+                line << "  bench_case_" << i << ": ";
+                line.append(num, format_fixed(num, sizeof(num), 1.5 * i, 3)) << " ns/op\n";
+            }
+        }
+        ::close(fd); }));
+}
+
+int main(int argc, char *argv[])
+{
+    log_line() << "Runnable helpers benchmarks:\n";
+
+    RUN_BENCH(bench_variant_dispatch);
+    RUN_BENCH(bench_callbacks);
+    RUN_BENCH(bench_string_view_scan);
+    RUN_BENCH(bench_parse_int);
+    RUN_BENCH(bench_format_number);
+    RUN_BENCH(bench_complex_arrays);
+    RUN_BENCH(bench_concept_dispatch);
+    RUN_BENCH(bench_lookup_tables);
+    RUN_BENCH(bench_small_sort);
+    RUN_BENCH(bench_large_sort);
+    RUN_BENCH(bench_short_strings);
+    RUN_BENCH(bench_column_scan);
+    RUN_BENCH(bench_thread_handoff);
+    RUN_BENCH(bench_read_mostly_locks);
+    RUN_BENCH(bench_memory_reclamation);
+    RUN_BENCH(bench_directory_walk);
+    RUN_BENCH(bench_file_reading);
+    RUN_BENCH(bench_async_reads);
+    RUN_BENCH(bench_chunked_generator);
+    RUN_BENCH(bench_harness_logging);
+
+    return 0;
+}
@@ -0,0 +1,211 @@
+/**
+ * Coroutine generator that hands out its values in batches. Requires C++20.
+ *
+ * The coroutine body still produces one value per `co_yield`, but a yield only appends to a
+ * buffer in the promise; the coroutine suspends just when that buffer holds a full chunk, or
+ * when it finishes with a partial one. The consumer gets each chunk as a std::span<const T>,
+ * valid until it asks for the next one, so the resume/suspend round trip is paid once per
+ * chunk instead of once per element. flatten() turns the chunks back into a plain range of
+ * elements for consumers that want them one at a time. A body that already holds a block of
+ * values, e.g. a decoded frame, can `co_yield` it as a std::span<const T> and it is passed
+ * through as a chunk of its own without being copied.
+ *
+ * The chunk size is taken from a leading chunk_size argument of the coroutine, if it has one:
+ *
+ *     chunk_generator<int> numbers(chunk_size, int n) { for (int i = 0; i < n; ++i) co_yield i; }
+ *     for (std::span<const int> chunk : numbers(chunk_size{1024}, 1'000'000)) ...
+ *
+ * The chunk buffer is allocated once, so T must be default constructible, and each yield is
+ * an assignment into it. An exception thrown by the body reaches the consumer once every value
+ * yielded before it has been handed out, from the call that would return the next chunk.
+ */
+
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <span>
+#include <utility>
+#include <vector>
+
+#ifndef __CHUNK_GENERATOR_HPP__
+#define __CHUNK_GENERATOR_HPP__
+
+struct chunk_size
+{
+    std::size_t elements = 256;
+};
+
+template <typename T>
+class chunk_generator
+{
+public:
+    struct promise_type
+    {
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        std::vector<T> buf; // sized once; the chunk is its first `len` elements
+        std::size_t len = 0;
+        std::span<const T> pending; // a block yielded whole, handed out after the buffer
+        std::exception_ptr error;
+
+        promise_type() : promise_type(chunk_size{}) {}
+        template <typename... Args>
+        promise_type(chunk_size size, Args &&...) : buf(size.elements > 0 ? size.elements : 1) {}
+
+        chunk_generator get_return_object()
+        {
+            return chunk_generator(handle_type::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        // suspends only once the chunk is full; otherwise the body just carries on
+        struct yield_awaiter
+        {
+            bool full;
+            bool await_ready() const noexcept { return !full; }
+            void await_suspend(std::coroutine_handle<>) const noexcept {}
+            void await_resume() const noexcept {}
+        };
+
+        template <typename U>
+            requires std::convertible_to<U, T>
+        yield_awaiter yield_value(U &&value)
+        {
+            buf[len++] = std::forward<U>(value);
+            return {len == buf.size()};
+        }
+        // a block the body already has in memory goes out as a chunk of its own, with no
+        // copy; it only has to stay valid until the body is resumed
+        yield_awaiter yield_value(std::span<const T> block)
+        {
+            pending = block;
+            return {!block.empty()};
+        }
+        void await_transform() = delete; // disallow co_await
+        void return_void() {}
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    explicit chunk_generator(promise_type::handle_type handle) : handle(handle) {}
+    chunk_generator(chunk_generator &&g) noexcept : handle(std::exchange(g.handle, {})) {}
+    chunk_generator &operator=(chunk_generator &&g) noexcept
+    {
+        if (this != &g)
+        {
+            if (handle)
+                handle.destroy();
+            handle = std::exchange(g.handle, {});
+        }
+        return *this;
+    }
+    chunk_generator(const chunk_generator &) = delete;
+    chunk_generator &operator=(const chunk_generator &) = delete;
+    ~chunk_generator()
+    {
+        if (handle)
+            handle.destroy();
+    }
+
+    // runs the body until it has filled the next chunk (or finished); an empty span means
+    // there is nothing left. The previous chunk is invalidated
+    std::span<const T> next()
+    {
+        if (!handle)
+            return {};
+        promise_type &p = handle.promise();
+        if (!p.pending.empty())
+            return std::exchange(p.pending, {});
+        p.len = 0;
+        if (p.error) // values that came before the exception have been handed out
+            std::rethrow_exception(std::exchange(p.error, nullptr));
+        if (handle.done())
+            return {};
+        handle.resume();
+        if (p.error && p.len == 0)
+            std::rethrow_exception(std::exchange(p.error, nullptr));
+        if (p.len > 0)
+            return {p.buf.data(), p.len}; // a pending block follows on the next call
+        return std::exchange(p.pending, {});
+    }
+
+    // range-for over the chunks
+    class iterator
+    {
+        chunk_generator *gen = nullptr;
+        std::span<const T> chunk;
+
+    public:
+        using value_type = std::span<const T>;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(chunk_generator *gen) : gen(gen), chunk(gen->next()) {}
+        const std::span<const T> &operator*() const { return chunk; }
+        iterator &operator++()
+        {
+            chunk = gen->next();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+        bool operator==(std::default_sentinel_t) const { return chunk.empty(); }
+    };
+
+    iterator begin() { return iterator(this); }
+    std::default_sentinel_t end() { return {}; }
+
+    // the elements of every chunk in turn, as one input range
+    class flat_view
+    {
+        chunk_generator *gen;
+
+    public:
+        class iterator
+        {
+            chunk_generator *gen = nullptr;
+            const T *cur = nullptr;
+            const T *last = nullptr;
+
+            void refill()
+            {
+                std::span<const T> chunk = gen->next();
+                cur = chunk.data();
+                last = cur + chunk.size();
+            }
+
+        public:
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+            explicit iterator(chunk_generator *gen) : gen(gen) { refill(); }
+            const T &operator*() const { return *cur; }
+            iterator &operator++()
+            {
+                if (++cur == last)
+                    refill();
+                return *this;
+            }
+            void operator++(int) { ++*this; }
+            bool operator==(std::default_sentinel_t) const { return cur == last; }
+        };
+
+        explicit flat_view(chunk_generator &gen) : gen(&gen) {}
+        iterator begin() { return iterator(gen); }
+        std::default_sentinel_t end() { return {}; }
+    };
+
+private:
+    promise_type::handle_type handle;
+};
+
+template <typename T>
+typename chunk_generator<T>::flat_view flatten(chunk_generator<T> &gen)
+{
+    return typename chunk_generator<T>::flat_view(gen);
+}
+
+#endif
@@ -0,0 +1,263 @@
+/**
+ * Compile-time integer powers and batched complex arithmetic in two memory layouts. Requires
+ * C++11.
+ *
+ * ipow<N>(x) raises x to a constant power by squaring, so x^N costs O(log N) multiplies that
+ * are fully unrolled at compile time, and folds to a constant when x is a constant.
+ *
+ * complex_array<L> holds n complex doubles in one buffer, either interleaved (re0 im0 re1 im1
+ * ..., the layout of an array of std::complex or of a {re, im} struct) or split (all real parts,
+ * then all imaginary parts). complex_kernels::add(), multiply(), conj(), abs() and dot()
+ * process whole arrays; over the split layout every loop is a plain element-wise loop over
+ * separate double arrays, which the compiler vectorizes directly, while the interleaved layout
+ * needs shuffles to pair up the parts. complex_buffer names the split layout, and under C++20
+ * it also hands out its real and imaginary parts as std::span, with no copy.
+ */
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+
+#ifndef __COMPLEX_ARRAY_HPP__
+#define __COMPLEX_ARRAY_HPP__
+
+namespace complex_array_detail
+{
+    template <typename T>
+    constexpr T sq(T x)
+    {
+        return x * x;
+    }
+
+    // x^N = (x^(N/2))^2, times x once more when N is odd; only N/2 is ever instantiated, so
+    // the recursion stops at the N = 0 specialization after log2(N) steps
+    template <unsigned N>
+    struct power
+    {
+        template <typename T>
+        static constexpr T of(T x)
+        {
+            return N % 2 ? x * sq(power<N / 2>::of(x)) : sq(power<N / 2>::of(x));
+        }
+    };
+
+    template <>
+    struct power<0>
+    {
+        template <typename T>
+        static constexpr T of(T)
+        {
+            return T(1);
+        }
+    };
+}
+
+template <unsigned N, typename T>
+constexpr T ipow(T x)
+{
+    return complex_array_detail::power<N>::of(x);
+}
+
+enum class complex_layout
+{
+    interleaved, // re0 im0 re1 im1 ...
+    split        // re0 re1 ... im0 im1 ...
+};
+
+template <complex_layout L>
+class complex_array
+{
+    std::vector<double> buf;
+    std::size_t n;
+
+    static constexpr bool is_split = L == complex_layout::split;
+    std::size_t re_index(std::size_t i) const { return is_split ? i : 2 * i; }
+    std::size_t im_index(std::size_t i) const { return is_split ? n + i : 2 * i + 1; }
+
+public:
+    explicit complex_array(std::size_t n = 0) : buf(2 * n), n(n) {}
+
+    std::size_t size() const { return n; }
+    double *data() { return buf.data(); }
+    const double *data() const { return buf.data(); }
+
+    double &re(std::size_t i) { return buf[re_index(i)]; }
+    double re(std::size_t i) const { return buf[re_index(i)]; }
+    double &im(std::size_t i) { return buf[im_index(i)]; }
+    double im(std::size_t i) const { return buf[im_index(i)]; }
+
+    void set(std::size_t i, double r, double m)
+    {
+        re(i) = r;
+        im(i) = m;
+    }
+
+#if __cplusplus >= 202002L
+    // the parts are only contiguous in the split layout
+    std::span<double> real() requires(is_split) { return {buf.data(), n}; }
+    std::span<const double> real() const requires(is_split) { return {buf.data(), n}; }
+    std::span<double> imag() requires(is_split) { return {buf.data() + n, n}; }
+    std::span<const double> imag() const requires(is_split) { return {buf.data() + n, n}; }
+#endif
+};
+
+// structure-of-arrays buffer of complex samples, the layout bulk arithmetic vectorizes on
+typedef complex_array<complex_layout::split> complex_buffer;
+
+namespace complex_array_detail
+{
+    inline void check_sizes(std::size_t a, std::size_t b)
+    {
+        if (a != b)
+            throw std::invalid_argument("complex_array sizes differ");
+    }
+
+    // the parts of element i are re[i * stride] and im[i * stride] in either layout
+    template <complex_layout L>
+    struct parts
+    {
+        static constexpr std::size_t stride = L == complex_layout::split ? 1 : 2;
+
+        static std::size_t offset(std::size_t n) { return L == complex_layout::split ? n : 1; }
+        static const double *re(const complex_array<L> &a) { return a.data(); }
+        static const double *im(const complex_array<L> &a) { return a.data() + offset(a.size()); }
+        static double *re(complex_array<L> &a) { return a.data(); }
+        static double *im(complex_array<L> &a) { return a.data() + offset(a.size()); }
+    };
+
+    // a * b + c in one rounding where the target has FMA instructions; otherwise std::fma
+    // would be a libm call per element, so fall back to a separate multiply and add
+    inline double fmadd(double a, double b, double c)
+    {
+#ifdef __FMA__
+        return std::fma(a, b, c);
+#else
+        return a * b + c;
+#endif
+    }
+}
+
+// the kernels have a namespace of their own, so that abs() and conj() do not overload the
+// standard names for every file that includes this header
+namespace complex_kernels
+{
+    // out[i] = a[i] + b[i]; out may alias a or b
+    template <complex_layout L>
+    void add(const complex_array<L> &a, const complex_array<L> &b, complex_array<L> &out)
+    {
+        typedef complex_array_detail::parts<L> parts;
+        complex_array_detail::check_sizes(a.size(), b.size());
+        complex_array_detail::check_sizes(a.size(), out.size());
+        const std::size_t s = parts::stride;
+        const double *ar = parts::re(a), *ai = parts::im(a), *br = parts::re(b), *bi = parts::im(b);
+        double *outr = parts::re(out), *outi = parts::im(out);
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            double r = ar[i * s] + br[i * s];
+            double m = ai[i * s] + bi[i * s];
+            outr[i * s] = r;
+            outi[i * s] = m;
+        }
+    }
+
+    // out[i] = conj(a[i]); out may alias a
+    template <complex_layout L>
+    void conj(const complex_array<L> &a, complex_array<L> &out)
+    {
+        typedef complex_array_detail::parts<L> parts;
+        complex_array_detail::check_sizes(a.size(), out.size());
+        const std::size_t s = parts::stride;
+        const double *ar = parts::re(a), *ai = parts::im(a);
+        double *outr = parts::re(out), *outi = parts::im(out);
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            outr[i * s] = ar[i * s];
+            outi[i * s] = -ai[i * s];
+        }
+    }
+
+    // out[i] = a[i] * b[i]; out may alias a or b
+    inline void multiply(const complex_array<complex_layout::split> &a,
+                         const complex_array<complex_layout::split> &b,
+                         complex_array<complex_layout::split> &out)
+    {
+        complex_array_detail::check_sizes(a.size(), b.size());
+        complex_array_detail::check_sizes(a.size(), out.size());
+        const std::size_t n = a.size();
+        const double *ar = a.data(), *ai = ar + n, *br = b.data(), *bi = br + n;
+        double *outr = out.data(), *outi = outr + n;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            double r = ar[i] * br[i] - ai[i] * bi[i];
+            double m = ar[i] * bi[i] + ai[i] * br[i];
+            outr[i] = r;
+            outi[i] = m;
+        }
+    }
+
+    inline void multiply(const complex_array<complex_layout::interleaved> &a,
+                         const complex_array<complex_layout::interleaved> &b,
+                         complex_array<complex_layout::interleaved> &out)
+    {
+        complex_array_detail::check_sizes(a.size(), b.size());
+        complex_array_detail::check_sizes(a.size(), out.size());
+        const double *pa = a.data(), *pb = b.data();
+        double *po = out.data();
+        for (std::size_t i = 0; i < 2 * a.size(); i += 2)
+        {
+            double r = pa[i] * pb[i] - pa[i + 1] * pb[i + 1];
+            double m = pa[i] * pb[i + 1] + pa[i + 1] * pb[i];
+            po[i] = r;
+            po[i + 1] = m;
+        }
+    }
+
+    // out[i] = |a[i]|, without the overflow protection of std::hypot; the loop only vectorizes
+    // with -fno-math-errno (which the Makefile sets for the bench target only), since std::sqrt
+    // must otherwise be able to set errno
+    template <complex_layout L>
+    void abs(const complex_array<L> &a, std::vector<double> &out)
+    {
+        out.resize(a.size());
+        for (std::size_t i = 0; i < a.size(); ++i)
+            out[i] = std::sqrt(ipow<2>(a.re(i)) + ipow<2>(a.im(i)));
+    }
+
+    // the sum of a[i] * b[i]; conj() one side first for the Hermitian inner product
+    template <complex_layout L>
+    std::complex<double> dot(const complex_array<L> &a, const complex_array<L> &b)
+    {
+        typedef complex_array_detail::parts<L> parts;
+        using complex_array_detail::fmadd;
+        complex_array_detail::check_sizes(a.size(), b.size());
+        const std::size_t s = parts::stride, n = a.size(), lanes = 4;
+        const double *ar = parts::re(a), *ai = parts::im(a), *br = parts::re(b), *bi = parts::im(b);
+        // without -ffast-math the compiler must add in source order, which serializes one sum on
+        // the add latency; four independent partial sums per part can run, and vectorize, in
+        // parallel (and round slightly differently from a sequential sum)
+        double re[lanes] = {}, im[lanes] = {};
+        std::size_t i = 0;
+        for (; i + lanes <= n; i += lanes)
+            for (std::size_t k = 0; k < lanes; ++k)
+            {
+                std::size_t j = (i + k) * s;
+                re[k] = fmadd(ar[j], br[j], fmadd(-ai[j], bi[j], re[k]));
+                im[k] = fmadd(ar[j], bi[j], fmadd(ai[j], br[j], im[k]));
+            }
+        for (; i < n; ++i)
+        {
+            re[0] = fmadd(ar[i * s], br[i * s], fmadd(-ai[i * s], bi[i * s], re[0]));
+            im[0] = fmadd(ar[i * s], bi[i * s], fmadd(ai[i * s], br[i * s], im[0]));
+        }
+        return std::complex<double>((re[0] + re[1]) + (re[2] + re[3]),
+                                    (im[0] + im[1]) + (im[2] + im[3]));
+    }
+}
+
+#endif
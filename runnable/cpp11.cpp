@@ -15,6 +15,8 @@
 #include <future>
 #include <cmath>
 #include "utils.hpp"
+#include "tracked.hpp"
+#include "complex_array.hpp"
 
 ////////////////////
 // Move semantics //
@@ -33,33 +35,24 @@ void test_std_move()
 
 struct ObjA
 {
-    std::string s;
-    std::string last_op;
+    // counts every copy & move of `s` in static counters, without allocating anything
+    typedef Tracked<std::string, ObjA> String;
+    String s;
     // constructor:
     ObjA() = delete;
-    ObjA(std::string arg) : s(arg)
-    {
-        last_op = "normal-construct";
-    }
+    ObjA(std::string arg) : s(std::move(arg)) {}
     // copy constructor & copy assignment operator:
-    ObjA(const ObjA &o) : s(o.s)
-    {
-        last_op = "copy-construct";
-    }
+    ObjA(const ObjA &o) : s(o.s) {}
     ObjA &operator=(const ObjA &o)
     {
-        last_op = "copy-assignment";
         s = o.s;
         return *this;
     }
-    // move constructor & move assignment operator:
-    ObjA(ObjA &&o) : s(std::move(o.s))
+    // move constructor & move assignment operator -- noexcept, or std::vector copies
+    // instead when it grows, to keep its strong exception guarantee
+    ObjA(ObjA &&o) noexcept : s(std::move(o.s)) {}
+    ObjA &operator=(ObjA &&o) noexcept
     {
-        last_op = "move-construct";
-    }
-    ObjA &operator=(ObjA &&o)
-    {
-        last_op = "move-assignment";
         s = std::move(o.s);
         return *this;
     }
@@ -70,27 +63,76 @@ ObjA make_A_rvalue(ObjA a)
     return a;
 }
 
+// returns the ObjA copy/move counts accumulated since the previous call
+static TrackedCounts take_A_counts()
+{
+    TrackedCounts c = ObjA::String::counts();
+    ObjA::String::reset_counts();
+    return c;
+}
+
 void test_move_ctor_assign_op()
 {
+    take_A_counts();
     ObjA a0("dummy0");        // normally constructed
     ObjA a1 = ObjA("dummy1"); // normally constructed
-    ObjA a2 = a1;             // copy constructed
+    TrackedCounts c = take_A_counts();
+    ASSERT_EQ(c.constructs, 2);
+    ASSERT_EQ(c.copies() + c.moves(), 0);
+    ObjA a2 = a1; // copy constructed
+    ASSERT_EQ(take_A_counts().copy_constructs, 1);
     ObjA a3("dummy3");
-    a3 = a1;                                 // copy assignment
+    take_A_counts();
+    a3 = a1; // copy assignment
+    ASSERT_EQ(take_A_counts().copy_assigns, 1);
     ObjA a4 = make_A_rvalue(ObjA("dummy4")); // move constructed from rvalue temporary
-    ObjA a5 = std::move(a1);                 // move constructed using std::move
+    c = take_A_counts();
+    ASSERT_EQ(c.move_constructs, 1);
+    ASSERT_EQ(c.copies(), 0);
+    ObjA a5 = std::move(a1); // move constructed using std::move
+    ASSERT_EQ(take_A_counts().move_constructs, 1);
     ObjA a6("dummy6");
+    take_A_counts();
     a6 = ObjA("temp2"); // move assignment from rvalue temporary
+    c = take_A_counts();
+    ASSERT_EQ(c.move_assigns, 1);
+    ASSERT_EQ(c.copies(), 0);
     ObjA a7("dummy7");
+    take_A_counts();
     a7 = std::move(a2); // move assignment using std::move
-    ASSERT_EQ(a0.last_op, "normal-construct");
-    ASSERT_EQ(a1.last_op, "normal-construct");
-    ASSERT_EQ(a2.last_op, "copy-construct");
-    ASSERT_EQ(a3.last_op, "copy-assignment");
-    ASSERT_EQ(a4.last_op, "move-construct");
-    ASSERT_EQ(a5.last_op, "move-construct");
-    ASSERT_EQ(a6.last_op, "move-assignment");
-    ASSERT_EQ(a7.last_op, "move-assignment");
+    c = take_A_counts();
+    ASSERT_EQ(c.move_assigns, 1);
+    ASSERT_EQ(c.copies(), 0);
+    ASSERT_EQ(a7.s.get(), "dummy1");
+}
+
+void test_vector_growth_moves()
+{
+    // reallocation moves the elements over only if their move constructor is noexcept
+    struct GrowthTag;
+    typedef Tracked<std::string, GrowthTag> String;
+    static_assert(std::is_nothrow_move_constructible<String>::value, "Tracked move may throw");
+    String::reset_counts();
+    String original("x");
+    String copy(original); // a non-const lvalue still goes to the copy constructor
+    ASSERT_EQ(String::counts().copy_constructs, 1);
+    String::reset_counts();
+    {
+        std::vector<String> strings;
+        for (int i = 0; i < 5; ++i)
+            strings.emplace_back("s");
+    }
+    TrackedCounts c = String::counts();
+    ASSERT_EQ(c.constructs, 5);
+    ASSERT_EQ(c.copies(), 0);
+    ASSERT_EQ(c.move_constructs, 7); // 1 + 2 + 4 elements moved by three reallocations
+    ASSERT_EQ(c.alive(), 0);
+
+    take_A_counts();
+    std::vector<ObjA> objs;
+    for (int i = 0; i < 5; ++i)
+        objs.emplace_back("a");
+    ASSERT_EQ(take_A_counts().copies(), 0);
 }
 
 ////////////////////////////////////
@@ -140,10 +182,15 @@ ObjA make_A_by_forwarding(T &&a)
 void test_std_forward()
 {
     ObjA a0("dummy");
+    take_A_counts();
     ObjA a1 = make_A_by_forwarding(a0);
+    TrackedCounts c = take_A_counts();
+    ASSERT_EQ(c.copy_constructs, 1);
+    ASSERT_EQ(c.moves(), 0);
     ObjA a2 = make_A_by_forwarding(std::move(a0));
-    ASSERT_EQ(a1.last_op, "copy-construct");
-    ASSERT_EQ(a2.last_op, "move-construct");
+    c = take_A_counts();
+    ASSERT_EQ(c.move_constructs, 1);
+    ASSERT_EQ(c.copies(), 0);
 }
 
 ////////////////////////
@@ -392,6 +439,70 @@ void test_constexpr_class()
     ASSERT(I.re == J.re && I.im == J.im);
 }
 
+// square() generalizes to any constant power: ipow<N> squares its way up in log2(N) steps
+static_assert(ipow<10>(2) == 1024, "ipow<10>(2) should be 1024");
+static_assert(ipow<0>(7) == 1 && ipow<1>(7) == 7, "ipow of 0 and 1 should be 1 and x");
+static_assert(ipow<63>(2ULL) == 1ULL << 63, "ipow should not lose bits");
+
+void test_constexpr_pow()
+{
+    double x = 1.5;
+    ASSERT_EQ(ipow<3>(x), 3.375); // x * x * x, computed as x * (x^1)^2
+    ASSERT_EQ(ipow<2>(-4), square(-4));
+    constexpr double half_to_the_10th = ipow<10>(0.5);
+    ASSERT_EQ(half_to_the_10th, 1.0 / 1024);
+}
+
+// arrays of Complex multiply the same way in either layout; only the memory order differs
+template <complex_layout L>
+void check_complex_array()
+{
+    complex_array<L> a(5), b(5), out(5);
+    for (int i = 0; i < 5; ++i)
+    {
+        a.set(i, i, 1);  // i + i*j
+        b.set(i, 2, -i); // 2 - i*j
+    }
+    complex_kernels::multiply(a, b, out); // (i + j)(2 - ij) = 3i + (2 - i^2)j
+    for (int i = 0; i < 5; ++i)
+    {
+        ASSERT_EQ(out.re(i), 3.0 * i);
+        ASSERT_EQ(out.im(i), 2.0 - i * i);
+    }
+    complex_kernels::multiply(out, out, out); // in place
+    ASSERT_EQ(out.re(1), 9.0 - 1.0);
+    ASSERT_EQ(out.im(1), 2 * 3.0 * 1.0);
+    std::vector<double> mags;
+    complex_kernels::abs(b, mags);
+    ASSERT_EQ(mags.size(), 5u);
+    ASSERT_EQ(mags[0], 2.0);
+    ASSERT_EQ(mags[2], std::sqrt(8.0));
+    complex_kernels::add(a, b, out);
+    complex_kernels::conj(out, out);
+    ASSERT_EQ(out.re(4), 6.0);
+    ASSERT_EQ(out.im(4), 3.0); // conj(4 + j + 2 - 4j)
+    std::complex<double> d = complex_kernels::dot(a, b); // sum of 3i + (2 - i^2)j
+    ASSERT_EQ(d.real(), 30.0);
+    ASSERT_EQ(d.imag(), 10.0 - 30.0);
+    complex_array<L> shorter(4);
+    EXPECT_THROW([&]
+                 { complex_kernels::multiply(a, shorter, out); });
+}
+
+void test_complex_arrays()
+{
+    check_complex_array<complex_layout::interleaved>();
+    check_complex_array<complex_layout::split>();
+    complex_array<complex_layout::interleaved> interleaved(3);
+    complex_array<complex_layout::split> split(3);
+    interleaved.set(1, 4, 5);
+    split.set(1, 4, 5);
+    ASSERT_EQ(interleaved.data()[2], 4.0); // re0 im0 re1 im1 ...
+    ASSERT_EQ(interleaved.data()[3], 5.0);
+    ASSERT_EQ(split.data()[1], 4.0); // re0 re1 re2 im0 im1 im2
+    ASSERT_EQ(split.data()[4], 5.0);
+}
+
 ////////////////////////////
 // Delegating constructor //
 ////////////////////////////
@@ -922,10 +1033,11 @@ void test_std_promise()
 
 int main(int argc, char *argv[])
 {
-    std::cout << "C++11 features runnable tests:" << std::endl;
+    log_line() << "C++11 features runnable tests:\n";
 
     RUN_EXAMPLE(test_std_move);
     RUN_EXAMPLE(test_move_ctor_assign_op);
+    RUN_EXAMPLE(test_vector_growth_moves);
     RUN_EXAMPLE(test_rvalue_references);
     RUN_EXAMPLE(test_forwarding_references);
     RUN_EXAMPLE(test_std_forward);
@@ -941,6 +1053,8 @@ int main(int argc, char *argv[])
     RUN_EXAMPLE(test_attributes);
     RUN_EXAMPLE(test_constexpr);
     RUN_EXAMPLE(test_constexpr_class);
+    RUN_EXAMPLE(test_constexpr_pow);
+    RUN_EXAMPLE(test_complex_arrays);
     RUN_EXAMPLE(test_delegating_ctor);
     RUN_EXAMPLE(test_user_defined_literals);
     RUN_EXAMPLE(test_explicit_override);
@@ -4,6 +4,7 @@
 #include <memory>
 #include <chrono>
 #include "utils.hpp"
+#include "units.hpp"
 
 /////////////////////
 // Binary literals //
@@ -189,6 +190,44 @@ void test_more_literals()
     ASSERT_EQ(day_minutes.count(), day_minutes_2.count());
 }
 
+void test_unit_literals()
+{
+    // strongly-typed quantities work like std::chrono durations: the unit is part of the type
+    // and conversions between units are folded into constants at compile time
+    using namespace units;
+    using namespace units::literals;
+    constexpr degrees_fahrenheit<double> body = 37_celsius;
+    static_assert(body.count() > 98.59 && body.count() < 98.61, "37C should be 98.6F");
+    constexpr auto boiling = quantity_cast<kelvins<double>>(100_celsius);
+    static_assert(boiling.count() > 373.149 && boiling.count() < 373.151, "100C should be 373.15K");
+    // integral representations truncate like std::chrono::duration_cast
+    ASSERT_EQ(quantity_cast<degrees_fahrenheit<long long>>(24_celsius).count(), 75);
+    ASSERT_EQ(quantity_cast<meters<int>>(3_km).count(), 3000);
+    constexpr meters<double> run = 1_mi + miles<double>(1);
+    ASSERT(run.count() > 3218.687 && run.count() < 3218.689);
+    ASSERT(1_km < 1_mi);
+    // implicit conversions only where no information is lost, as with chrono
+    static_assert(std::is_convertible<miles<int>, feet<int>>::value, "5280 ft per mile");
+    static_assert(!std::is_convertible<feet<int>, miles<int>>::value, "would truncate");
+    static_assert(std::is_convertible<feet<int>, miles<double>>::value, "floating target");
+    static_assert(!std::is_convertible<miles<double>, feet<int>>::value, "floating source");
+    static_assert(!std::is_convertible<meters<double>, kelvins<double>>::value, "dimensions");
+    ASSERT(feet<long long>(miles<long long>(1)) == feet<long long>(5280));
+    // between integer reps the conversion is exact integer arithmetic
+    feet<long long> far = miles<long long>(1000000000000001);
+    ASSERT_EQ(far.count(), 5280000000000005280LL);
+    ASSERT_EQ(quantity_cast<kelvins<int>>(degrees_celsius<int>(100)).count(), 373); // truncates
+    // mixed units meet at their common type, whichever side they are on
+    ASSERT(feet<int>(5280) == miles<int>(1) && miles<int>(1) == feet<int>(5280));
+    ASSERT(feet<int>(1) < miles<int>(1) && miles<int>(1) > feet<int>(1));
+    static_assert(std::is_same<decltype(miles<int>(1) + feet<int>(1)), feet<int>>::value, "");
+    ASSERT_EQ((feet<int>(1) + miles<int>(1)).count(), 5281);
+    ASSERT_EQ((miles<int>(1) - feet<int>(1)).count(), 5279);
+    ASSERT_EQ((2 * meters<int>(3)).count(), (meters<int>(3) * 2).count());
+    ASSERT(kelvins<int>(274) > degrees_celsius<int>(0)); // compared in hundredths of a kelvin
+    // meters<double> bad = 3_celsius;  // compile error -- different dimensions
+}
+
 ///////////////////////////
 // std::integer_sequence //
 ///////////////////////////
@@ -243,7 +282,7 @@ void test_std_make_unique()
 
 int main(int argc, char *argv[])
 {
-    std::cout << "C++14 features runnable tests:" << std::endl;
+    log_line() << "C++14 features runnable tests:\n";
 
     RUN_EXAMPLE(test_binary_literals);
     RUN_EXAMPLE(test_generic_lambda);
@@ -254,6 +293,7 @@ int main(int argc, char *argv[])
     RUN_EXAMPLE(test_variable_templates);
     RUN_EXAMPLE(test_deprecated_attribute);
     RUN_EXAMPLE(test_more_literals);
+    RUN_EXAMPLE(test_unit_literals);
     RUN_EXAMPLE(test_std_integer_sequence);
     RUN_EXAMPLE(test_std_make_unique);
 
@@ -3,15 +3,34 @@
 #include <vector>
 #include <variant>
 #include <any>
+#include <optional>
 #include <atomic>
 #include <mutex>
+#include <shared_mutex>
+#include <thread>
 #include <filesystem>
+#include <fstream>
 #include <map>
 #include <unordered_map>
 #include <set>
 #include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <random>
 #include <execution>
 #include "utils.hpp"
+#include "fast_visit.hpp"
+#include "function_ref.hpp"
+#include "sv_utils.hpp"
+#include "make_table.hpp"
+#include "static_sort.hpp"
+#include "inline_string.hpp"
+#include "format_number.hpp"
+#include "soa_vector.hpp"
+#include "ring_buffer.hpp"
+#include "rw_locks.hpp"
+#include "reclamation.hpp"
+#include "dir_walker.hpp"
 
 /////////////////////////
 // Folding expressions //
@@ -57,6 +76,91 @@ void test_constexpr_lambdas()
     static_assert(identity(123) == 123);
 }
 
+// reflected CRC-32 (polynomial 0xEDB88320) of a single byte
+constexpr uint32_t crc32_of_byte(std::size_t b)
+{
+    uint32_t c = static_cast<uint32_t>(b);
+    for (int k = 0; k < 8; ++k)
+        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+    return c;
+}
+
+void test_constexpr_tables()
+{
+    // constexpr lambdas (or functions) expanded over an index sequence give lookup tables
+    // that are baked into the binary instead of being filled at startup
+    constexpr auto crc_table = make_table<256>(crc32_of_byte);
+    static_assert(crc_table[1] == 0x77073096u && crc_table[255] == 0x2D02EF8Du);
+    auto crc32 = [&](std::string_view data)
+    {
+        uint32_t c = 0xFFFFFFFFu;
+        for (unsigned char ch : data)
+            c = crc_table[(c ^ ch) & 0xFF] ^ (c >> 8);
+        return c ^ 0xFFFFFFFFu;
+    };
+    ASSERT_EQ(crc32("123456789"), 0xCBF43926u);
+    auto popcount = [](std::size_t i) constexpr
+    { return static_cast<uint8_t>(__builtin_popcount(i)); };
+    static constexpr auto popcount16 = make_table<65536>(popcount);
+    static_assert(popcount16.size() == 65536 && popcount16[0xFFFF] == 16);
+    ASSERT_EQ(popcount16[0b1011'0001], 4);
+    // any integer sequence works, not just 0..N-1
+    constexpr auto squares = make_table([](int i) constexpr
+                                        { return i * i; },
+                                        std::integer_sequence<int, 3, 1, 4>{});
+    static_assert(squares[0] == 9 && squares[1] == 1 && squares[2] == 16);
+}
+
+template <std::size_t N>
+bool sorts_all_binary_inputs()
+{
+    // 0-1 principle: a comparator network sorts everything iff it sorts all 0/1 inputs
+    for (uint32_t bits = 0; bits < (1u << N); ++bits)
+    {
+        std::array<int, N> a{};
+        for (std::size_t i = 0; i < N; ++i)
+            a[i] = (bits >> i) & 1;
+        static_sort(a);
+        if (!std::is_sorted(a.begin(), a.end()))
+            return false;
+    }
+    return true;
+}
+
+void test_static_sort()
+{
+    // a sorting network generated and unrolled at compile time -- no branches on the data
+    std::array<int, 3> a = {2, 1, 3};
+    static_sort(a);
+    ASSERT_EQ(a, (std::array<int, 3>{1, 2, 3}));
+    constexpr auto sorted = []() constexpr
+    {
+        std::array<int, 5> b{5, -1, 4, 4, 0};
+        static_sort(b, std::greater<>{});
+        return b;
+    }();
+    static_assert(sorted[0] == 5 && sorted[2] == 4 && sorted[4] == -1);
+    static_assert(static_sort_comparators<4> == 5 && static_sort_comparators<8> == 19);
+    ASSERT(sorts_all_binary_inputs<7>());
+    ASSERT(sorts_all_binary_inputs<12>());
+    ASSERT(sorts_all_binary_inputs<16>());
+    std::array<std::string, 32> words;
+    for (std::size_t i = 0; i < words.size(); ++i)
+        words[i] = std::to_string((i * 7919) % 32);
+    auto expected = words;
+    std::sort(expected.begin(), expected.end());
+    static_sort(words);
+    ASSERT_EQ(words, expected);
+    // non-arithmetic elements are swapped rather than copied, so move-only types sort too
+    std::array<std::unique_ptr<int>, 4> owned;
+    for (std::size_t i = 0; i < owned.size(); ++i)
+        owned[i] = std::make_unique<int>(3 - static_cast<int>(i));
+    static_sort(owned, [](const auto &x, const auto &y)
+                { return *x < *y; });
+    for (std::size_t i = 0; i < owned.size(); ++i)
+        ASSERT_EQ(*owned[i], static_cast<int>(i));
+}
+
 //////////////////////
 // inline variables //
 //////////////////////
@@ -78,6 +182,187 @@ void test_inline_variables()
     ASSERT_EQ(a0.x, a1.x);
 }
 
+// a shared atomic counter is the simplest way to hand work between threads; bounded lock-free
+// rings hand over whole items, with the producer and consumer each owning their own index
+void test_ring_buffers()
+{
+    constexpr int N = 100000;
+
+    // SPSC: items arrive in order, single pushes mixed with batches
+    spsc_ring<int> spsc(64);
+    ASSERT_EQ(spsc.capacity(), 64u);
+    std::thread producer([&]
+                         {
+        int batch[16];
+        for (int i = 0; i < N;)
+        {
+            if (i % 3 == 0)
+            {
+                int n = std::min(16, N - i);
+                for (int k = 0; k < n; ++k)
+                    batch[k] = i + k;
+                int pushed = 0;
+                while (pushed < n)
+                    pushed += static_cast<int>(spsc.push_batch(batch + pushed, n - pushed));
+                i += n;
+            }
+            else
+            {
+                while (!spsc.try_push(i))
+                    std::this_thread::yield();
+                ++i;
+            }
+        } });
+    int expected = 0, out[32];
+    while (expected < N)
+    {
+        std::size_t n = spsc.pop_batch(out, 32);
+        for (std::size_t k = 0; k < n; ++k)
+            ASSERT_EQ(out[k], expected++);
+        if (n == 0)
+            std::this_thread::yield();
+    }
+    producer.join();
+    int dummy;
+    ASSERT(!spsc.try_pop(dummy));
+
+    // MPMC: every item is delivered exactly once across all consumers
+    mpmc_queue<int> mpmc(128);
+    ASSERT_EQ(mpmc.capacity(), 128u);
+    constexpr int P = 3, C = 3;
+    std::atomic<long long> sum(0);
+    std::atomic<int> received(0);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < P; ++p)
+        threads.emplace_back([&, p]
+                             {
+            for (int i = p; i < N; i += P)
+                while (!mpmc.try_push(i))
+                    std::this_thread::yield(); });
+    for (int c = 0; c < C; ++c)
+        threads.emplace_back([&]
+                             {
+            int buf[8];
+            while (received.load() < N)
+            {
+                std::size_t n = mpmc.pop_batch(buf, 8);
+                for (std::size_t k = 0; k < n; ++k)
+                    sum += buf[k];
+                received += static_cast<int>(n);
+                if (n == 0)
+                    std::this_thread::yield();
+            } });
+    for (auto &t : threads)
+        t.join();
+    ASSERT_EQ(received.load(), N);
+    ASSERT_EQ(sum.load(), static_cast<long long>(N) * (N - 1) / 2);
+
+    // a full queue rejects pushes, a batch push stops at the free space
+    mpmc_queue<int> small(4);
+    int four[] = {1, 2, 3, 4};
+    ASSERT_EQ(small.push_batch(four, 4), 4u);
+    ASSERT(!small.try_push(5));
+    ASSERT_EQ(small.pop_batch(out, 3), 3u);
+    ASSERT_EQ(small.push_batch(four, 4), 3u);
+    ASSERT_EQ(small.pop_batch(out, 32), 4u);
+    ASSERT_EQ(out[0], 4);
+    ASSERT_EQ(out[3], 3);
+}
+
+template <typename Domain>
+void check_reclaimed_structures()
+{
+    constexpr int N = 20000, T = 3;
+    Domain domain;
+
+    // stack: every pushed value is popped exactly once, popped nodes are freed later
+    lock_free_stack<int, Domain> stack(domain);
+    stack.push(1);
+    stack.push(2);
+    ASSERT_EQ(stack.pop().value(), 2);
+    ASSERT_EQ(stack.pop().value(), 1);
+    ASSERT(!stack.pop());
+    std::atomic<long long> sum(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < T; ++t)
+        threads.emplace_back([&, t]
+                             {
+            for (int i = t; i < N; i += T)
+            {
+                stack.push(i);
+                if (auto v = stack.pop())
+                    sum += *v;
+            } });
+    for (auto &t : threads)
+        t.join();
+    while (auto v = stack.pop())
+        sum += *v;
+    ASSERT_EQ(sum.load(), static_cast<long long>(N) * (N - 1) / 2);
+    for (int i = 0; i < 3; ++i)
+        domain.reclaim();
+    ASSERT_EQ(domain.pending(), 0u);
+
+    // list: a sorted set where removal unlinks and retires nodes while others traverse
+    lock_free_list<int, Domain> list(domain);
+    ASSERT(list.insert(2) && list.insert(1) && !list.insert(2));
+    ASSERT(list.remove(1) && !list.remove(1));
+    ASSERT(list.contains(2) && !list.contains(1));
+    threads.clear();
+    for (int t = 0; t < T; ++t)
+        threads.emplace_back([&, t]
+                             {
+            for (int k = t; k < 300; k += T)
+                list.insert(k);
+            for (int k = t; k < 300; k += T)
+                if (k % 2)
+                    list.remove(k);
+            for (int k = 0; k < 300; ++k)
+                list.contains(k); });
+    for (auto &t : threads)
+        t.join();
+    for (int k = 0; k < 300; ++k)
+        ASSERT_EQ(list.contains(k), k % 2 == 0);
+}
+
+void test_memory_reclamation()
+{
+    // lock-free structures built on atomics like global_counter cannot delete an unlinked node
+    // right away; a reclamation domain defers it until no thread can still be reading it
+    check_reclaimed_structures<ebr_domain>();
+    check_reclaimed_structures<hazard_domain>();
+
+    // a pinned thread holds back every node retired since it pinned
+    ebr_domain ebr;
+    lock_free_stack<int, ebr_domain> stack(ebr);
+    stack.push(1);
+    {
+        auto g = ebr.pin();
+        stack.pop();
+        ebr.reclaim();
+        ebr.reclaim();
+        ASSERT_EQ(ebr.pending(), 1u);
+    }
+    ebr.reclaim();
+    ebr.reclaim();
+    ASSERT_EQ(ebr.pending(), 0u);
+
+    // a hazard pointer holds back exactly the node it points at
+    hazard_domain hp;
+    std::atomic<int *> shared(new int(1));
+    {
+        auto g = hp.pin();
+        int *p = g.protect(0, shared);
+        shared.store(new int(2));
+        hp.retire(p);
+        ASSERT_EQ(hp.reclaim(), 0u);
+        ASSERT_EQ(*p, 1);
+        EXPECT_THROW([&]
+                     { hp.pin(); }); // guards do not nest
+    }
+    ASSERT_EQ(hp.reclaim(), 1u);
+    delete shared.load();
+}
+
 ///////////////////////
 // Nested namespaces //
 ///////////////////////
@@ -128,6 +413,51 @@ void test_structured_bindings()
     ASSERT_EQ(sum, 3);
 }
 
+void test_soa_structured_bindings()
+{
+    // records stored column by column; rows come back as tuples of references, so structured
+    // bindings still name the fields of one record
+    soa_vector<int, const char *, double> profiles;
+    profiles.push_back(24, "Jose", 179.5);
+    profiles.push_back(std::make_tuple(31, "Ana", 165.0));
+    auto [age, name, height] = profiles[0];
+    ASSERT_EQ(age, 24);
+    ASSERT_EQ(std::string(name), "Jose");
+    height = 180.0; // binds to the element stored in the container
+    ASSERT_EQ(std::get<2>(profiles[0]), 180.0);
+    int total_age = 0;
+    for (auto [a, n, h] : profiles)
+    {
+        total_age += a;
+        h += 1; // proxy references write through
+        (void)n;
+    }
+    ASSERT_EQ(total_age, 55);
+    // scanning one field only walks one contiguous array
+    auto heights = profiles.column<2>();
+    ASSERT_EQ(heights.size(), 2u);
+    ASSERT_EQ(heights[0] + heights[1], 181.0 + 166.0);
+    ASSERT_EQ(heights.data() + 1, &heights[1]);
+    // a field that fails to construct leaves every column at the old row count
+    struct positive
+    {
+        int v;
+        positive(int v) : v(v)
+        {
+            if (v <= 0)
+                throw std::invalid_argument("not positive");
+        }
+    };
+    soa_vector<int, positive> checked;
+    checked.push_back(1, 1);
+    EXPECT_THROW([&]
+                 { checked.push_back(2, -2); }); // thrown after column 0 took its field
+    ASSERT_EQ(checked.size(), 1u);
+    checked.push_back(3, 3);
+    ASSERT_EQ(std::get<0>(checked[1]), 3);
+    ASSERT_EQ(std::get<1>(checked[1]).v, 3);
+}
+
 /////////////////////////////
 // if & switch initializer //
 /////////////////////////////
@@ -145,6 +475,69 @@ void test_if_initializer()
     ASSERT_EQ(shared_vec, std::vector<int>{1});
 }
 
+struct ConfigSnapshot
+{
+    int version;
+    int limit;
+    double ratio;
+};
+
+void test_read_mostly_locks()
+{
+    // read-only checks need not exclude each other: shared locks let readers run in parallel
+    static distributed_rw_lock rw;
+    if (std::shared_lock lk(rw); !shared_vec.empty())
+    {
+        ASSERT_EQ(shared_vec.front(), 1);
+    }
+    if (std::unique_lock lk(rw); shared_vec.size() == 1)
+    {
+        shared_vec.push_back(2);
+    }
+    ASSERT_EQ(shared_vec, (std::vector<int>{1, 2}));
+    ASSERT(rw.try_lock_shared());
+    ASSERT(!rw.try_lock());
+    rw.unlock_shared();
+    ASSERT(rw.try_lock());
+    ASSERT(!rw.try_lock_shared());
+    rw.unlock();
+
+    // readers always see a consistent snapshot, whichever lock protects it
+    constexpr int UPDATES = 2000;
+    seqlock<ConfigSnapshot> config(ConfigSnapshot{0, 0, 0.0});
+    ConfigSnapshot guarded{0, 0, 0.0};
+    std::atomic<bool> done(false), torn(false);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t)
+        readers.emplace_back([&]
+                             {
+            while (!done.load())
+            {
+                ConfigSnapshot c = config.load();
+                if (c.limit != 2 * c.version || c.ratio != c.version / 2.0)
+                    torn = true;
+                std::shared_lock lk(rw);
+                if (guarded.limit != 2 * guarded.version)
+                    torn = true;
+            } });
+    for (int v = 1; v <= UPDATES; ++v)
+    {
+        config.update([v](ConfigSnapshot &c)
+                      {
+            c.version = v;
+            c.limit = 2 * v;
+            c.ratio = v / 2.0; });
+        std::lock_guard<distributed_rw_lock> lk(rw);
+        guarded.version = v;
+        guarded.limit = 2 * v;
+    }
+    done = true;
+    for (auto &t : readers)
+        t.join();
+    ASSERT(!torn.load());
+    ASSERT_EQ(config.load().version, UPDATES);
+}
+
 struct ObjB
 {
     enum Status
@@ -282,6 +675,44 @@ void test_std_variant()
     ASSERT_EQ(std::get<std::string>(thing), "str");
 }
 
+struct ObjCVisitor
+{
+    int operator()(int x) const { return x; }
+    int operator()(double d) const { return static_cast<int>(d * 10); }
+    int operator()(const ObjC &c) const { return c.x + c.y; }
+    int operator()(const std::string &s) const { return static_cast<int>(s.size()); }
+};
+
+void test_fast_visit()
+{
+    // same semantics as std::visit, but dispatch is a plain switch (single variant) or a
+    // compile-time function pointer table (multiple variants), independent of the compiler
+    using Msg = std::variant<int, double, ObjC, std::string>;
+    std::vector<Msg> msgs{7, 1.5, ObjC{2, 3}, std::string("four")};
+    std::vector<int> results;
+    for (const auto &m : msgs)
+        results.push_back(fast_visit(ObjCVisitor{}, m));
+    ASSERT_EQ(results, (std::vector<int>{7, 15, 5, 4}));
+    for (const auto &m : msgs)
+        ASSERT_EQ(fast_visit(ObjCVisitor{}, m), std::visit(ObjCVisitor{}, m));
+    // visitor may mutate the alternative in place
+    Msg thing{2};
+    fast_visit([](auto &v)
+               { if constexpr (std::is_same_v<std::decay_t<decltype(v)>, int>) v += 40; },
+               thing);
+    ASSERT_EQ(std::get<int>(thing), 42);
+    // multi-variant visitation
+    std::variant<int, double> a{3}, b{0.5};
+    auto mul = [](auto x, auto y) -> double
+    { return x * y; };
+    ASSERT_EQ(fast_visit(mul, a, b), 1.5);
+    ASSERT_EQ(fast_visit(mul, a, a), 9.0);
+    std::variant<char, std::string> c{'x'};
+    auto kinds = [](const auto &x, const auto &y, const auto &z)
+    { return sizeof(x) + sizeof(y) + sizeof(z); };
+    ASSERT_EQ(fast_visit(kinds, a, b, c), sizeof(int) + sizeof(double) + sizeof(char));
+}
+
 //////////////
 // std::any //
 //////////////
@@ -340,6 +771,110 @@ void test_std_string_view()
     ASSERT_EQ(const_view, "something constant");
 }
 
+void test_string_view_utils()
+{
+    // trimming, splitting, and line iteration that hand out views into the original buffer
+    std::string str(" \t  trim me \r\n");
+    ASSERT_EQ(trim_left(str), "trim me \r\n");
+    ASSERT_EQ(trim_right(str), " \t  trim me");
+    ASSERT_EQ(trim(str), "trim me");
+    ASSERT_EQ(trim(" \n "), "");
+    std::string padded = std::string(100, ' ') + "x" + std::string(70, '\t');
+    ASSERT_EQ(trim(padded), "x");
+    ASSERT_EQ(trim(padded).data(), padded.data() + 100); // no copy
+    std::vector<std::string_view> fields;
+    for (auto f : split("a,,bc,", ','))
+        fields.push_back(f);
+    ASSERT_EQ(fields, (std::vector<std::string_view>{"a", "", "bc", ""}));
+    std::string log;
+    for (int i = 0; i < 50; ++i)
+        log += "line " + std::to_string(i) + (i % 2 ? "\r\n" : "\n");
+    int count = 0;
+    for (auto line : lines(log))
+    {
+        ASSERT_EQ(line, "line " + std::to_string(count));
+        ++count;
+    }
+    ASSERT_EQ(count, 50);
+    std::vector<std::string_view> blank;
+    for (auto line : lines("\n"))
+        blank.push_back(line);
+    ASSERT_EQ(blank, (std::vector<std::string_view>{""})); // std::getline reads one empty line
+    ASSERT(lines("").begin() == lines("").end());
+    ASSERT_EQ(find_byte(log, '9'), log.find('9'));
+    ASSERT_EQ(find_byte(log, '#'), std::string_view::npos);
+    ASSERT_EQ(find_byte(log, 'l', log.size()), std::string_view::npos);
+    ASSERT_EQ(find_byte(log, 'l', std::string_view::npos - 1), std::string_view::npos);
+}
+
+void test_inline_string()
+{
+    // short strings (status messages, tags, keys) stored inline, without any heap allocation
+    static_assert(std::is_trivially_copyable_v<inline_string<15>>);
+    static_assert(sizeof(inline_string<14>) == 16);
+    inline_string<15> op = "move-construct";
+    ASSERT_EQ(op.size(), 14u);
+    ASSERT_EQ(op, "move-construct");
+    std::string_view view = op;
+    ASSERT_EQ(view, "move-construct");
+    auto copy = op; // a plain memcpy
+    copy += '!';
+    ASSERT_EQ(copy, "move-construct!");
+    ASSERT_NE(copy, op);
+    EXPECT_THROW([&]
+                 { copy += "overflow"; });
+    ASSERT_EQ(copy, "move-construct!"); // unchanged after the failed append
+    constexpr inline_string<8> status = "not_ok";
+    static_assert(status.view() == "not_ok");
+    std::unordered_map<inline_string<15>, int> counts;
+    counts["ok"]++;
+    counts["not_ok"]++;
+    counts["ok"]++;
+    ASSERT_EQ(counts.at("ok"), 2);
+    ASSERT_EQ(counts.at("not_ok"), 1);
+}
+
+void test_number_formatting()
+{
+    // std::to_string(1.2f) is "1.200000": printf's fixed six decimals, in a fresh std::string.
+    // format_number writes the shortest text that reads back as the same value instead
+    char buf[max_chars<double>];
+    auto formatted = [&](auto v)
+    { return std::string_view(buf, format_number(buf, buf + sizeof(buf), v) - buf); };
+    ASSERT_EQ(formatted(1.2f), "1.2");
+    ASSERT_EQ(formatted(0.1), "0.1");
+    ASSERT_EQ(formatted(0.1f + 0.2f), "0.3");
+    ASSERT_EQ(formatted(0.1 + 0.2), "0.30000000000000004"); // the double really is not 0.3
+    ASSERT_EQ(formatted(1e21), "1e+21");
+    ASSERT_EQ(formatted(-0.0), "-0");
+    ASSERT_EQ(formatted(123u), "123");
+    ASSERT_EQ(formatted(std::numeric_limits<int64_t>::min()), "-9223372036854775808");
+    ASSERT_EQ(formatted(-std::numeric_limits<double>::denorm_min()), "-5e-324");
+    static_assert(max_chars<float> == 15 && max_chars<double> == 24 && max_chars<uint64_t> == 20);
+    ASSERT(format_number(buf, buf + 2, 123) == nullptr); // too small: nothing is truncated
+    std::mt19937_64 rng(46);
+    for (int i = 0; i < 1000; ++i)
+    {
+        uint64_t bits = rng();
+        double v;
+        std::memcpy(&v, &bits, sizeof(v));
+        if (v != v)
+            continue; // NaN payloads do not round-trip through text
+        std::string_view text = formatted(v);
+        ASSERT(text.size() <= max_chars<double>);
+        double back = 0;
+        std::from_chars(text.data(), text.data() + text.size(), back);
+        ASSERT_EQ(std::memcmp(&back, &v, sizeof(v)), 0);
+    }
+    inline_string<15> key = to_inline_string(2.5f);
+    ASSERT_EQ(key, "2.5");
+    std::string row = "x=";
+    append_number(row, 42);
+    row += ",y=";
+    append_number(row, 0.25);
+    ASSERT_EQ(row, "x=42,y=0.25");
+}
+
 ///////////////////////////////
 // Generic callable invokers //
 ///////////////////////////////
@@ -368,6 +903,55 @@ void test_std_invoke()
     ASSERT_EQ(result, 3.3);
 }
 
+static double add_int_double(int x, double y)
+{
+    return x + y;
+}
+
+static double call_twice(function_ref<double(int, double)> f)
+{
+    return f(1, 2.3) + f(2, 0.5);
+}
+
+void test_function_ref()
+{
+    // type-erased callables that never allocate: function_ref only refers to the callable
+    // (so it must outlive the call), inplace_function owns a copy in a fixed inline buffer
+    double offset = 10;
+    auto add_func = [&offset](int x, double y)
+    { return x + y + offset; };
+    ASSERT_EQ(call_twice(add_func), 25.8);
+    offset = 0; // referenced, not copied
+    ASSERT_EQ(call_twice(add_func), 5.8);
+    ASSERT_EQ(call_twice(add_int_double), 5.8);
+    ASSERT_EQ(call_twice(&add_int_double), 5.8);
+    ASSERT_EQ(sizeof(function_ref<double(int, double)>), 2 * sizeof(void *));
+    inplace_function<int(int), 16> inc;
+    ASSERT(!inc);
+    EXPECT_THROW([&]
+                 { inc(0); });
+    int step = 2;
+    inc = [step](int x)
+    { return x + step; };
+    auto inc_copy = inc;
+    step = 100; // captured by value
+    ASSERT_EQ(inc(1), 3);
+    ASSERT_EQ(inc_copy(5), 7);
+    // callable through a const reference, and the target may still change its own state
+    const inplace_function<int(), 16> counter = [n = 0]() mutable
+    { return ++n; };
+    counter();
+    ASSERT_EQ(counter(), 2);
+    // callables that are too big, or not copyable, are rejected at compile time
+    auto too_big = [a = std::array<int, 4>{}](int)
+    { return a[0]; };
+    auto move_only = [p = std::unique_ptr<int>()](int)
+    { return p ? 1 : 0; };
+    static_assert(!std::is_constructible_v<inplace_function<int(int), 8>, decltype(too_big)>);
+    static_assert(std::is_constructible_v<inplace_function<int(int), 16>, decltype(too_big)>);
+    static_assert(!std::is_constructible_v<inplace_function<int(int), 16>, decltype(move_only)>);
+}
+
 void test_std_apply()
 {
     // call any callable object with arguments as a tuple
@@ -387,6 +971,78 @@ void test_std_filesystem()
     ASSERT(!exists);
 }
 
+void test_parallel_walk()
+{
+    namespace fs = std::filesystem;
+    fs::path root = fs::temp_directory_path() / ("cpp17_walk_" + std::to_string(::getpid()));
+    fs::remove_all(root);
+    for (int d = 0; d < 4; ++d)
+        for (int s = 0; s < 3; ++s)
+        {
+            fs::path dir = root / ("d" + std::to_string(d)) / ("s" + std::to_string(s));
+            fs::create_directories(dir);
+            for (int f = 0; f < 5; ++f)
+                std::ofstream(dir / ("f" + std::to_string(f))) << std::string(d * 100 + f, 'x');
+        }
+    fs::create_directory_symlink(root / "d0", root / "link"); // listed, but not followed
+
+    // the reference: a single-threaded walk collecting everything into a set
+    std::set<std::string> expected;
+    uint64_t expected_bytes = 0;
+    for (const auto &e : fs::recursive_directory_iterator(root))
+    {
+        expected.insert(e.path().string());
+        if (e.is_regular_file() && !e.is_symlink())
+            expected_bytes += e.file_size();
+    }
+
+    // the parallel walk streams entries from several threads, so the callback locks
+    std::mutex m;
+    std::set<std::string> seen;
+    std::atomic<uint64_t> bytes(0), symlinks(0);
+    walk_options options;
+    options.threads = 4;
+    walk_stats stats = parallel_walk(root, [&](const walk_entry &e)
+                                     {
+        if (e.type == fs::file_type::regular)
+            bytes += e.size;
+        if (e.type == fs::file_type::symlink)
+            ++symlinks;
+        std::lock_guard<std::mutex> lk(m);
+        seen.emplace(e.path); }, options);
+    ASSERT_EQ(seen, expected);
+    ASSERT_EQ(stats.entries, expected.size());
+    ASSERT_EQ(stats.directories, 1u + 4 + 4 * 3);
+    ASSERT_EQ(stats.errors, 0u);
+    ASSERT_EQ(bytes.load(), expected_bytes);
+    ASSERT_EQ(symlinks.load(), 1u);
+
+    // without stat, types come from the directory listing alone
+    options.stat = false;
+    std::atomic<uint64_t> files(0);
+    parallel_walk(root, [&](const walk_entry &e)
+                  { files += e.type == fs::file_type::regular && e.size == 0; }, options);
+    ASSERT_EQ(files.load(), 4u * 3 * 5);
+
+    ASSERT_EQ(parallel_walk(root / "missing", [](const walk_entry &) {}).errors, 1u);
+
+    // a throwing callback stops the walk, and its exception comes out of parallel_walk()
+    std::string what;
+    try
+    {
+        parallel_walk(root, [](const walk_entry &e)
+                      {
+            if (e.path.substr(e.path.size() - 2) == "f3")
+                throw std::runtime_error("stop at f3"); }, options);
+    }
+    catch (const std::runtime_error &e)
+    {
+        what = e.what();
+    }
+    ASSERT_EQ(what, "stop at f3");
+    fs::remove_all(root);
+}
+
 //////////////////////
 // Splicing methods //
 //////////////////////
@@ -424,25 +1080,37 @@ void test_parallel_algos()
 
 int main(int argc, char *argv[])
 {
-    std::cout << "C++17 features runnable tests:" << std::endl;
+    log_line() << "C++17 features runnable tests:\n";
 
     RUN_EXAMPLE(test_folding_exprs);
     RUN_EXAMPLE(test_constexpr_lambdas);
+    RUN_EXAMPLE(test_constexpr_tables);
+    RUN_EXAMPLE(test_static_sort);
     RUN_EXAMPLE(test_inline_variables);
+    RUN_EXAMPLE(test_ring_buffers);
+    RUN_EXAMPLE(test_memory_reclamation);
     RUN_EXAMPLE(test_nested_namespaces);
     RUN_EXAMPLE(test_structured_bindings);
+    RUN_EXAMPLE(test_soa_structured_bindings);
     RUN_EXAMPLE(test_if_initializer);
+    RUN_EXAMPLE(test_read_mostly_locks);
     RUN_EXAMPLE(test_switch_initializer);
     RUN_EXAMPLE(test_if_constexpr);
     RUN_EXAMPLE(test_more_attributes);
     RUN_EXAMPLE(test_has_include);
     RUN_EXAMPLE(test_std_variant);
+    RUN_EXAMPLE(test_fast_visit);
     RUN_EXAMPLE(test_std_any);
     RUN_EXAMPLE(test_std_optional);
     RUN_EXAMPLE(test_std_string_view);
+    RUN_EXAMPLE(test_string_view_utils);
+    RUN_EXAMPLE(test_inline_string);
+    RUN_EXAMPLE(test_number_formatting);
     RUN_EXAMPLE(test_std_invoke);
+    RUN_EXAMPLE(test_function_ref);
     RUN_EXAMPLE(test_std_apply);
     RUN_EXAMPLE(test_std_filesystem);
+    RUN_EXAMPLE(test_parallel_walk);
     RUN_EXAMPLE(test_map_splicing);
     RUN_EXAMPLE(test_set_splicing);
     RUN_EXAMPLE(test_parallel_algos);
@@ -3,14 +3,35 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <deque>
+#include <list>
 #include <coroutine>
+#include <optional>
 #include <span>
 #include <bit>
 #include <numbers>
 #include <numeric>
 #include <cstdlib>
 #include <ctime>
+#include <random>
+#include <algorithm>
+#include <complex>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <syncstream>
+#include <thread>
 #include "utils.hpp"
+#include "parse_int.hpp"
+#include "lookup_tables.hpp"
+#include "parallel_sort.hpp"
+#include "intern.hpp"
+#include "sv_utils.hpp"
+#include "mapped_file.hpp"
+#include "complex_array.hpp"
+#include "dispatch_algos.hpp"
+#include "async_file.hpp"
+#include "chunk_generator.hpp"
 
 ////////////////
 // Coroutines //
@@ -106,6 +127,157 @@ void test_coroutines()
     ASSERT_EQ(vec, (std::vector<int>{0, 1, 2, 3, 4}));
 }
 
+// the same sequence as range_gen, but the coroutine suspends once per chunk of values rather
+// than once per value
+template <std::integral T>
+chunk_generator<T> range_chunks(chunk_size, T start, const T end)
+{
+    while (start < end)
+        co_yield start++; // only appends to the chunk until it is full
+}
+
+// a decoder that produces whole frames passes them through; loose values are still batched
+chunk_generator<int> frames_and_values()
+{
+    std::vector<int> frame{10, 11, 12};
+    co_yield 1;
+    co_yield std::span<const int>(frame); // no copy: the consumer reads `frame` itself
+    co_yield 2;
+    co_yield 3;
+}
+
+chunk_generator<int> failing_after(int n)
+{
+    for (int i = 0; i < n; ++i)
+        co_yield i;
+    throw std::runtime_error("decoder error");
+}
+
+void test_chunked_generator()
+{
+    std::vector<size_t> sizes;
+    std::vector<int> vec;
+    for (std::span<const int> chunk : range_chunks(chunk_size{4}, 0, 10))
+    {
+        sizes.push_back(chunk.size());
+        vec.insert(vec.end(), chunk.begin(), chunk.end());
+    }
+    ASSERT_EQ(sizes, (std::vector<size_t>{4, 4, 2})); // the last chunk is partial
+    std::vector<int> expected;
+    auto gen = range_gen(0, 10);
+    while (auto n = gen.next())
+        expected.push_back(n.value());
+    ASSERT_EQ(vec, expected);
+
+    // flatten() walks the elements of the chunks for per-element consumers
+    auto chunks = range_chunks(chunk_size{3}, 0, 1000);
+    int sum = 0, count = 0;
+    for (int v : flatten(chunks))
+    {
+        sum += v;
+        ++count;
+    }
+    ASSERT_EQ(count, 1000);
+    ASSERT_EQ(sum, 999 * 1000 / 2);
+    ASSERT(chunks.next().empty()); // exhausted
+    auto empty = range_chunks(chunk_size{8}, 5, 5);
+    ASSERT(empty.begin() == empty.end());
+    std::vector<std::vector<int>> parts;
+    for (std::span<const int> chunk : frames_and_values())
+        parts.emplace_back(chunk.begin(), chunk.end());
+    ASSERT_EQ(parts, (std::vector<std::vector<int>>{{1}, {10, 11, 12}, {2, 3}}));
+
+    // no chunk_size argument: the default size; an exception reaches the consumer after the
+    // values yielded before it
+    auto failing = failing_after(300);
+    std::vector<int> received;
+    EXPECT_THROW([&]
+                 {
+        for (std::span<const int> chunk = failing.next(); !chunk.empty(); chunk = failing.next())
+            received.insert(received.end(), chunk.begin(), chunk.end()); });
+    ASSERT_EQ(received.size(), 300u); // the partial last chunk arrived before the throw
+    ASSERT_EQ(received.back(), 299);
+    ASSERT(failing.next().empty());
+}
+
+// reads every `stride`-th chunk starting at chunk `first`, checking each byte of it
+io_task read_chunks(async_reader &reader, int fd, int first, int stride, int chunks,
+                    size_t chunk, int &verified)
+{
+    std::vector<std::byte> buf(chunk);
+    for (int c = first; c < chunks; c += stride)
+    {
+        int64_t n = co_await reader.read(fd, buf, c * chunk);
+        if (n != static_cast<int64_t>(chunk))
+            throw std::runtime_error("short read");
+        for (size_t i = 0; i < chunk; ++i)
+            if (std::to_integer<size_t>(buf[i]) != (c * chunk + i) % 251)
+                throw std::runtime_error("wrong data");
+        ++verified;
+    }
+}
+
+io_task read_into_slot(async_reader &reader, int fd, unsigned slot, uint64_t offset,
+                       int64_t &result)
+{
+    result = co_await reader.read_fixed(fd, slot, reader.buffer(slot).size(), offset);
+}
+
+void test_async_file_reads()
+{
+    // coroutines suspend on each read; a single thread in run() keeps all of them in flight
+    namespace fs = std::filesystem;
+    fs::path path = fs::temp_directory_path() / ("cpp20_async_" + std::to_string(::getpid()));
+    constexpr int CHUNKS = 64;
+    constexpr size_t CHUNK = 4096;
+    {
+        std::ofstream out(path, std::ios::binary);
+        for (size_t i = 0; i < CHUNKS * CHUNK; ++i)
+            out.put(static_cast<char>(i % 251));
+    }
+    int fd = ::open(path.c_str(), O_RDONLY);
+    ASSERT(fd >= 0);
+    for (bool fallback : {false, true})
+    {
+        async_reader reader({.queue_depth = 4, .registered_buffer_size = CHUNK,
+                             .force_fallback = fallback});
+        if (fallback)
+            ASSERT(!reader.uses_io_uring());
+        // more coroutines than queue slots: the extra reads wait for a free slot
+        int verified = 0;
+        std::vector<io_task> tasks;
+        for (int t = 0; t < 6; ++t)
+            tasks.push_back(read_chunks(reader, fd, t, 6, CHUNKS, CHUNK, verified));
+        ASSERT(!tasks[0].done());
+        reader.run();
+        for (auto &t : tasks)
+        {
+            ASSERT(t.done());
+            t.get();
+        }
+        ASSERT_EQ(verified, CHUNKS);
+
+        // registered buffers, reads at EOF, and errors come back as -errno like pread
+        int64_t at_end = -1, past_end = -1, bad_fd = 0;
+        io_task a = read_into_slot(reader, fd, 0, CHUNKS * CHUNK - 10, at_end);
+        io_task b = read_into_slot(reader, fd, 1, CHUNKS * CHUNK + 10, past_end);
+        io_task c = read_into_slot(reader, -1, 2, 0, bad_fd);
+        reader.run();
+        ASSERT_EQ(at_end, 10);
+        ASSERT_EQ(std::to_integer<size_t>(reader.buffer(0)[9]), (CHUNKS * CHUNK - 1) % 251);
+        ASSERT_EQ(past_end, 0);
+        ASSERT_EQ(bad_fd, -EBADF);
+
+        // a task dropped mid-read leaves its coroutine running until it is done
+        verified = 0;
+        read_chunks(reader, fd, 0, 1, CHUNKS, CHUNK, verified); // destroyed right away
+        reader.run();
+        ASSERT_EQ(verified, CHUNKS);
+    }
+    ::close(fd);
+    fs::remove(path);
+}
+
 //////////////
 // Concepts //
 //////////////
@@ -170,6 +342,74 @@ void test_concepts_exprs()
     ASSERT_EQ(result, 1);
 }
 
+// concepts also rank overloads: among viable candidates the most constrained one wins, so an
+// overload set can pick the fastest loop for whatever iterators it is given
+static_assert(memmove_copyable<int *, int *>);
+static_assert(memmove_copyable<std::vector<char>::iterator, char *>);
+static_assert(!memmove_copyable<std::vector<std::string>::iterator, std::string *>);
+static_assert(!memmove_copyable<std::deque<int>::iterator, int *>);
+static_assert(contiguous_scalars<std::span<const double>::iterator>);
+static_assert(!contiguous_scalars<std::list<int>::iterator>);
+
+// every path accepts exactly the values `*first = value` accepts, so an int does not fill a
+// scoped enum even though the contiguous path could cast it
+enum class level
+{
+    low,
+    high
+};
+template <typename I, typename T>
+concept fast_fillable = requires(I it, const T &value) { fast_fill(it, it, value); };
+static_assert(fast_fillable<std::vector<level>::iterator, level>);
+static_assert(!fast_fillable<std::vector<level>::iterator, int>);
+static_assert(!fast_fillable<std::list<level>::iterator, int>);
+
+void test_concept_dispatch()
+{
+    std::vector<int> ints(100);
+    std::iota(ints.begin(), ints.end(), 0);
+    std::deque<int> deq(ints.begin(), ints.end());
+    std::list<int> lst(ints.begin(), ints.end());
+    std::vector<int> out(100);
+
+    // contiguous + trivially copyable: a memmove
+    ASSERT(fast_copy(ints.begin(), ints.end(), out.begin()) == out.end());
+    ASSERT_EQ(out, ints);
+    // random access: blocked loop; anything else: element by element
+    std::fill(out.begin(), out.end(), 0);
+    fast_copy(deq.begin() + 10, deq.end(), out.begin());
+    ASSERT_EQ(out[0], 10);
+    fast_copy(lst.begin(), lst.end(), out.begin());
+    ASSERT_EQ(out, ints);
+    std::vector<int> appended;
+    fast_copy(ints.begin(), ints.begin() + 3, std::back_inserter(appended));
+    ASSERT_EQ(appended, (std::vector<int>{0, 1, 2}));
+
+    for (int v : {0, 7, 8, 99, 100, -1})
+    {
+        auto expected = std::find(ints.begin(), ints.end(), v) - ints.begin();
+        ASSERT_EQ(fast_find(ints.begin(), ints.end(), v) - ints.begin(), expected);
+        ASSERT_EQ(fast_find(deq.begin(), deq.end(), v) - deq.begin(), expected);
+        ASSERT_EQ(std::distance(lst.begin(), fast_find(lst.begin(), lst.end(), v)), expected);
+    }
+    std::string text = "find the first 'q' in here: quick";
+    ASSERT_EQ(fast_find(text.begin(), text.end(), 'q') - text.begin(), 16); // memchr
+    ASSERT(fast_find(text.begin(), text.end(), 'q' + 256) == text.end());
+
+    fast_fill(ints.begin() + 50, ints.end(), 7);
+    fast_fill(deq.begin(), deq.begin() + 20, 7);
+    fast_fill(text.begin(), text.begin() + 4, '-'); // memset
+    ASSERT_EQ(text.substr(0, 6), "---- t");
+    ASSERT_EQ(fast_count(ints.begin(), ints.end(), 7), 51);
+    ASSERT_EQ(fast_count(deq.begin(), deq.end(), 7), 20);
+    ASSERT_EQ(fast_count(lst.begin(), lst.end(), 7), 1);
+    ASSERT_EQ(fast_count(text.begin(), text.end(), '-'), 4);
+    std::vector<char> bytes(1000, 'a');
+    ASSERT_EQ(fast_count(bytes.begin(), bytes.end(), 'a'), 1000); // past one 8-bit counter
+    std::vector<std::string> words{"a", "b", "a"};
+    ASSERT_EQ(fast_count(words.begin(), words.end(), "a"), 2);
+}
+
 //////////////////////////////////////
 // Range-based for loop initializer //
 //////////////////////////////////////
@@ -258,6 +498,83 @@ void test_consteval()
     static_assert(sqr(10) == 100);
 }
 
+void test_consteval_literal()
+{
+    // an immediate user-defined literal: parsed by the compiler, not by std::stoi at run-time
+    using namespace parse_int_literals;
+    static_assert("123"_int == 123);
+    static_assert("-2147483648"_int == std::numeric_limits<int>::min());
+    constexpr int n = "42"_int; // "4x2"_int would not compile
+    ASSERT_EQ(n, 42);
+    // its run-time counterpart never throws and needs no NUL terminator
+    std::string_view digits = "1234567890123456789|0012";
+    ASSERT_EQ(parse_int<int64_t>(digits.substr(0, 19)), 1234567890123456789);
+    ASSERT_EQ(parse_int(digits.substr(20)), 12);
+    ASSERT_EQ(parse_int("-98765432"), -98765432);
+    ASSERT_EQ(parse_int("2147483647"), 2147483647);
+    ASSERT(!parse_int("2147483648"));
+    ASSERT_EQ(parse_int<uint8_t>("255"), 255);
+    ASSERT(!parse_int<uint8_t>("256"));
+    ASSERT(!parse_int<unsigned>("-1"));
+    ASSERT(!parse_int(""));
+    ASSERT(!parse_int("-"));
+    ASSERT(!parse_int("12345678x"));
+    ASSERT(!parse_int(" 1"));
+    ASSERT_EQ(parse_int<int64_t>("-00000000000000000000000000042"), -42); // from_chars path
+    ASSERT(!parse_int<int64_t>("99999999999999999999"));
+}
+
+constexpr uint64_t factorial_recursive(uint64_t n)
+{
+    return n <= 1 ? 1 : n * factorial_recursive(n - 1);
+}
+
+void test_consteval_tables()
+{
+    // whole tables are computed by immediate functions, so looking up n! or C(n, k) at
+    // run-time is a single load; entries that would overflow are rejected at compile time
+    static_assert(max_factorial_n<uint64_t>() == 20);
+    static_assert(max_factorial_n<unsigned __int128>() == 34);
+    static_assert(factorials<uint64_t>.size() == 21);
+    static_assert(factorial_lookup(20) == 2432902008176640000ull);
+    volatile std::size_t n = 15;
+    ASSERT_EQ(factorial_lookup(n), factorial_recursive(n));
+    auto f30 = factorial_lookup<unsigned __int128>(30);
+    ASSERT_EQ(static_cast<uint64_t>(f30 / factorial_lookup<unsigned __int128>(28)), 30u * 29u);
+    static_assert(max_binomial_n<uint64_t>() == 67);
+    static_assert(binomial_lookup(67, 33) == 14226520737620288370ull);
+    ASSERT_EQ(binomial_lookup(n, 5), factorial_recursive(15) / factorial_recursive(5) / factorial_recursive(10));
+    ASSERT_EQ(binomial_lookup(5, 7), 0u);
+    constexpr auto fib = fibonacci_table<uint32_t, 48>();
+    static_assert(fib[10] == 55 && fib[47] == 2971215073u);
+    // fibonacci_table<uint32_t, 49>() or factorial_table<uint64_t, 22>() would not compile
+}
+
+inline constexpr string_table status_names{"ok", "not_ok", "lvalue-reference", "rvalue-reference"};
+
+constexpr uint32_t status_of(bool valid)
+{
+    return valid ? status_names.id("ok") : status_names.id("not_ok");
+}
+
+void test_consteval_interning()
+{
+    // string literals turned into integers by immediate functions, so that status values are
+    // produced and compared without building or comparing any strings at run-time
+    using namespace intern_literals;
+    constexpr interned ok = "ok"_sid;
+    static_assert(ok == intern("ok"));
+    static_assert(!(ok == "not_ok"_sid));
+    static_assert(ok.id == fnv1a_64("ok")); // stable: same ID in every TU and every build
+    ASSERT_EQ(ok.str, "ok");
+    volatile bool valid = false;
+    uint32_t s = status_of(valid);
+    ASSERT_EQ(s, status_names.id("not_ok"));
+    ASSERT_EQ(status_names.name(s), "not_ok");
+    static_assert(status_names.size() == 4 && status_names.id("rvalue-reference") == 3);
+    // status_names.id("unknown") or a table with a repeated name would not compile
+}
+
 ////////////////
 // using enum //
 ////////////////
@@ -306,6 +623,132 @@ void test_std_span()
     ASSERT_EQ(sum1, 26);
 }
 
+void test_span_sorting()
+{
+    // sorting algorithms that take any contiguous range as a std::span
+    std::mt19937_64 rng(34);
+    std::vector<int64_t> keys(100000);
+    for (auto &k : keys)
+        k = static_cast<int64_t>(rng()) >> (rng() % 64);
+    auto expected = keys;
+    std::sort(expected.begin(), expected.end());
+    auto radix = keys;
+    radix_sort(std::span(radix));
+    ASSERT_EQ(radix, expected);
+    std::array<uint16_t, 6> small{300, 7, 65535, 0, 7, 256};
+    radix_sort(std::span(small));
+    ASSERT_EQ(small, (std::array<uint16_t, 6>{0, 7, 7, 256, 300, 65535}));
+    static_assert(radix_key<char> && !radix_key<bool>); // bool keys go to std::sort
+    auto merged = keys;
+    parallel_merge_sort(std::span(merged), std::less<>{}, 4);
+    ASSERT_EQ(merged, expected);
+    // general comparators, many duplicates, and non-trivial element types
+    std::vector<std::string> words;
+    for (int i = 0; i < 50000; ++i)
+        words.push_back(std::to_string(rng() % 1000));
+    auto sorted_words = words;
+    std::sort(sorted_words.begin(), sorted_words.end(), std::greater<>{});
+    parallel_merge_sort(std::span(words), std::greater<>{}, 3);
+    ASSERT_EQ(words, sorted_words);
+    // nearly all keys equal: the merge still splits into even parts, cut by position
+    std::vector<int> ties(100000, 7);
+    for (std::size_t i = 0; i < ties.size(); i += 1000)
+        ties[i] = static_cast<int>(i % 3);
+    auto sorted_ties = ties;
+    std::sort(sorted_ties.begin(), sorted_ties.end());
+    parallel_merge_sort(std::span(ties), std::less<>{}, 4);
+    ASSERT_EQ(ties, sorted_ties);
+    // elements need not be default constructible
+    struct id
+    {
+        explicit id(int v) : v(v) {}
+        int v;
+    };
+    std::vector<id> ids;
+    for (int i = 0; i < 20000; ++i)
+        ids.emplace_back(static_cast<int>(rng() % 5000));
+    auto by_v = [](const id &a, const id &b)
+    { return a.v < b.v; };
+    parallel_merge_sort(std::span(ids), by_v, 4);
+    ASSERT(std::is_sorted(ids.begin(), ids.end(), by_v));
+    // an exception thrown by the comparator on a worker thread reaches the caller
+    std::atomic<int> calls(0);
+    EXPECT_THROW([&]
+                 { parallel_merge_sort(std::span(keys), [&](int64_t a, int64_t b)
+                                       {
+                    if (++calls == 100000)
+                        throw std::runtime_error("comparator failed");
+                    return a < b; }, 4); });
+}
+
+void test_complex_buffer_spans()
+{
+    // a structure-of-arrays complex buffer: each part is its own contiguous array, handed out
+    // as a span, so code written against plain double arrays runs on it with no copy
+    complex_buffer a(1000), b(1000), out(1000);
+    std::span<double> re = a.real(), im = a.imag();
+    ASSERT_EQ(re.size(), 1000u);
+    ASSERT_EQ(im.data(), re.data() + 1000);
+    std::iota(re.begin(), re.end(), 0.0);
+    std::fill(im.begin(), im.end(), 1.0);
+    std::ranges::fill(b.real(), 0.5);
+    std::ranges::fill(b.imag(), -2.0);
+    complex_kernels::add(a, b, out);
+    ASSERT_EQ(std::complex(out.re(10), out.im(10)), std::complex(10.5, -1.0));
+    complex_kernels::conj(out, out);
+    ASSERT_EQ(out.imag()[10], 1.0);
+    complex_kernels::multiply(a, b, out);
+    ASSERT_EQ(std::complex(out.re(3), out.im(3)), std::complex(3.0, 1.0) * std::complex(0.5, -2.0));
+    std::vector<double> mags;
+    complex_kernels::abs(b, mags);
+    ASSERT_EQ(mags[999], std::sqrt(4.25));
+
+    // dot product over all samples: sum of (i + j)(0.5 - 2j) = sum of (0.5i + 2) + (0.5 - 2i)j
+    std::complex<double> d = complex_kernels::dot(a, b);
+    ASSERT_EQ(d.real(), 0.5 * 999 * 1000 / 2 + 2 * 1000);
+    ASSERT_EQ(d.imag(), 0.5 * 1000 - 2.0 * 999 * 1000 / 2);
+    const complex_buffer &view = a;
+    std::span<const double> const_re = view.real();
+    ASSERT_EQ(const_re[999], 999.0);
+}
+
+void test_mapped_file()
+{
+    // a file mapped into memory is just another contiguous range: span and string_view code
+    // runs over it directly, with no copy into a buffer
+    namespace fs = std::filesystem;
+    fs::path path = fs::temp_directory_path() / ("cpp20_mapped_" + std::to_string(::getpid()));
+    std::ofstream(path) << "id,name\r\n1,ada\r\n2,grace\r\n";
+    mapped_file::options opts;
+    opts.pattern = mapped_file::access::sequential;
+    opts.willneed = true;
+    opts.hugepages = true; // just a hint, ignored where unsupported
+    mapped_file file(path, opts);
+    ASSERT_EQ(file.size(), 25u);
+    ASSERT(file.view().starts_with("id,name"));
+    std::span<const std::byte> bytes = file.bytes();
+    ASSERT_EQ(bytes.size(), file.size());
+    ASSERT_EQ(std::to_integer<char>(bytes.back()), '\n');
+    std::vector<std::string_view> names;
+    for (std::string_view line : lines(file.view()))
+        names.push_back(*++split(line, ',').begin());
+    ASSERT_EQ(names, (std::vector<std::string_view>{"name", "ada", "grace"}));
+    ASSERT_EQ(names[1].data(), file.view().data() + 11); // points into the mapping
+    file.prefetch(10, 5);
+    file.advise(mapped_file::access::random);
+
+    // move-only ownership of the mapping, like a unique_ptr
+    mapped_file moved = std::move(file);
+    ASSERT(file.empty() && moved.size() == 25u);
+    moved = mapped_file(path, {.populate = true});
+    ASSERT_EQ(moved.view().substr(9, 5), "1,ada");
+    std::ofstream(path, std::ios::trunc).flush();
+    ASSERT(mapped_file(path).view().empty());
+    fs::remove(path);
+    EXPECT_THROW([&]
+                 { mapped_file missing(path); });
+}
+
 /////////////////
 // Bit helpers //
 /////////////////
@@ -390,19 +833,87 @@ void test_std_to_array()
     ASSERT_EQ(arr, (std::array<char, 4>{'f', 'o', 'o', '\0'}));
 }
 
+/////////////////////////
+// Synchronized output //
+/////////////////////////
+
+void test_synchronized_output()
+{
+    // std::osyncstream collects what one thread writes and hands it to the wrapped stream in
+    // one piece when it is destroyed, so whole lines from concurrent threads never interleave
+    auto check_lines = [](const std::string &text, int threads, int per_thread)
+    {
+        std::istringstream in(text);
+        std::vector<int> seen(threads);
+        std::string line;
+        while (std::getline(in, line))
+        {
+            int t = line[7] - '0';
+            ASSERT_EQ(line, "worker " + std::to_string(t) + " line " + std::to_string(seen[t]));
+            ++seen[t];
+        }
+        for (int n : seen)
+            ASSERT_EQ(n, per_thread);
+    };
+    auto run_workers = [](int threads, auto write_line)
+    {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+            workers.emplace_back([&, t]
+                                 {
+                for (int i = 0; i < 200; ++i)
+                    write_line(t, i); });
+        for (auto &w : workers)
+            w.join();
+    };
+    std::ostringstream out;
+    run_workers(4, [&](int t, int i)
+                { std::osyncstream(out) << "worker " << t << " line " << i << '\n'; });
+    check_lines(out.str(), 4, 200);
+
+    // log_line does the same without a stream or an allocation: it formats into a fixed
+    // buffer and appends it to the log_sink under one lock
+    namespace fs = std::filesystem;
+    fs::path path = fs::temp_directory_path() / ("cpp20_log_" + std::to_string(::getpid()));
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    ASSERT(fd >= 0);
+    {
+        log_sink sink(fd);
+        run_workers(4, [&](int t, int i)
+                    { log_line(sink) << "worker " << t << " line " << i << '\n'; });
+    } // the sink flushes its buffer on destruction
+    ::close(fd);
+    std::ostringstream text;
+    text << std::ifstream(path).rdbuf();
+    check_lines(text.str(), 4, 200);
+    fs::remove(path);
+
+    char buf[32];
+    ASSERT_EQ(std::string_view(buf, format_fixed(buf, sizeof(buf), -2.5, 3)), "-2.500");
+}
+
 int main(int argc, char *argv[])
 {
-    std::cout << "C++20 features runnable tests:" << std::endl;
+    log_line() << "C++20 features runnable tests:\n";
 
     RUN_EXAMPLE(test_coroutines);
+    RUN_EXAMPLE(test_chunked_generator);
+    RUN_EXAMPLE(test_async_file_reads);
     RUN_EXAMPLE(test_concepts_basic);
     RUN_EXAMPLE(test_concepts_exprs);
+    RUN_EXAMPLE(test_concept_dispatch);
     RUN_EXAMPLE(test_range_based_for_initializer);
     RUN_EXAMPLE(test_likely_unlikely);
     RUN_EXAMPLE(test_explicit_ctor);
     RUN_EXAMPLE(test_consteval);
+    RUN_EXAMPLE(test_consteval_literal);
+    RUN_EXAMPLE(test_consteval_tables);
+    RUN_EXAMPLE(test_consteval_interning);
     // RUN_EXAMPLE(test_using_enum);
     RUN_EXAMPLE(test_std_span);
+    RUN_EXAMPLE(test_span_sorting);
+    RUN_EXAMPLE(test_complex_buffer_spans);
+    RUN_EXAMPLE(test_mapped_file);
     RUN_EXAMPLE(test_bit_helpers);
     RUN_EXAMPLE(test_math_constants);
     RUN_EXAMPLE(test_std_is_constant_evaluated);
@@ -410,6 +921,7 @@ int main(int argc, char *argv[])
     RUN_EXAMPLE(test_check_contains);
     RUN_EXAMPLE(test_std_midpoint);
     RUN_EXAMPLE(test_std_to_array);
+    RUN_EXAMPLE(test_synchronized_output);
 
     return 0;
 }
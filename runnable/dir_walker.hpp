@@ -0,0 +1,357 @@
+/**
+ * Parallel recursive directory walker. Requires C++17 and Linux (openat/readdir/statx).
+ *
+ * parallel_walk(root, callback, options) lists `root` recursively on a small work-stealing
+ * pool: every worker pushes the subdirectories it finds onto its own deque and pops from the
+ * back, and an idle worker steals from the front of another worker's deque, which tends to
+ * hand it a large subtree near the top. Each subdirectory is queued with a descriptor of its
+ * parent and opened with openat() by its name alone, and the metadata of all the entries of a
+ * directory is fetched with statx() relative to its open descriptor once it has been read in
+ * one go, so the kernel never resolves a full path again and nothing is stat'ed when
+ * options.stat is off (the type then comes from d_type).
+ *
+ * Entries are streamed to the callback as they are found, without building a list. The
+ * callback runs concurrently on the worker threads and must be thread-safe; the path it gets
+ * is only valid during the call. Directories that cannot be opened are skipped and counted;
+ * one whose listing fails partway is counted too, and the entries read until then are still
+ * reported. If the
+ * callback throws, the first exception stops the walk: every worker finishes the directory it
+ * is on without further callbacks, and parallel_walk() rethrows it once they have all joined.
+ *
+ * A worker whose deque is empty and that finds nothing to steal does not block while others
+ * are still reading (their directories may yet produce work); it spins, yielding its time
+ * slice after a few empty rounds, until new work appears or the walk is over.
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef __DIR_WALKER_HPP__
+#define __DIR_WALKER_HPP__
+
+struct walk_entry
+{
+    std::string_view path;
+    std::filesystem::file_type type;
+    uint64_t size;    // 0 unless stat'ed
+    int64_t mtime_ns; // 0 unless stat'ed
+};
+
+struct walk_options
+{
+    unsigned threads = std::thread::hardware_concurrency();
+    bool stat = true; // fetch size and mtime for every entry
+};
+
+struct walk_stats
+{
+    uint64_t entries;
+    uint64_t directories; // read successfully, including the root
+    uint64_t errors;      // directories that could not be opened or read
+};
+
+namespace dir_walker_detail
+{
+    inline std::filesystem::file_type from_d_type(unsigned char t)
+    {
+        using ft = std::filesystem::file_type;
+        switch (t)
+        {
+        case DT_REG:
+            return ft::regular;
+        case DT_DIR:
+            return ft::directory;
+        case DT_LNK:
+            return ft::symlink;
+        case DT_BLK:
+            return ft::block;
+        case DT_CHR:
+            return ft::character;
+        case DT_FIFO:
+            return ft::fifo;
+        case DT_SOCK:
+            return ft::socket;
+        default:
+            return ft::unknown;
+        }
+    }
+
+    inline std::filesystem::file_type from_mode(uint16_t mode)
+    {
+        using ft = std::filesystem::file_type;
+        switch (mode & S_IFMT)
+        {
+        case S_IFREG:
+            return ft::regular;
+        case S_IFDIR:
+            return ft::directory;
+        case S_IFLNK:
+            return ft::symlink;
+        case S_IFBLK:
+            return ft::block;
+        case S_IFCHR:
+            return ft::character;
+        case S_IFIFO:
+            return ft::fifo;
+        case S_IFSOCK:
+            return ft::socket;
+        default:
+            return ft::unknown;
+        }
+    }
+
+    struct dir_closer
+    {
+        void operator()(DIR *d) const { ::closedir(d); }
+    };
+    using dir_handle = std::unique_ptr<DIR, dir_closer>;
+
+    struct unique_fd
+    {
+        int fd;
+        explicit unique_fd(int fd) : fd(fd) {}
+        unique_fd(const unique_fd &) = delete;
+        unique_fd &operator=(const unique_fd &) = delete;
+        ~unique_fd()
+        {
+            if (fd >= 0)
+                ::close(fd);
+        }
+    };
+
+    // a directory still to be read: its full path, for the callback, and a descriptor of its
+    // parent to open it by name; the root, or a directory whose parent could not be kept
+    // open, has no parent and is opened by path
+    struct dir_task
+    {
+        std::shared_ptr<const unique_fd> parent;
+        std::string path;
+        std::size_t name = 0; // offset of the last component in `path`
+    };
+
+    struct alignas(64) work_queue
+    {
+        std::mutex m;
+        std::deque<dir_task> dirs;
+    };
+
+    template <typename Callback>
+    class walker
+    {
+        Callback &callback;
+        const walk_options &options;
+        std::vector<work_queue> queues;
+        // directories queued or being read; the walk is over when it drops to zero
+        std::atomic<uint64_t> pending{0};
+        std::atomic<uint64_t> entries{0}, directories{0}, errors{0};
+        // the first exception out of a callback, rethrown by run(); `stopped` ends the walk
+        std::mutex error_m;
+        std::exception_ptr error;
+        std::atomic<bool> stopped{false};
+
+        struct dirent_batch
+        {
+            std::vector<char> names; // NUL-separated
+            std::vector<std::pair<std::size_t, unsigned char>> items; // name offset, d_type
+        };
+
+        void push(std::size_t self, dir_task dir)
+        {
+            pending.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lk(queues[self].m);
+            queues[self].dirs.push_back(std::move(dir));
+        }
+
+        bool pop(std::size_t self, dir_task &dir)
+        {
+            {
+                std::lock_guard<std::mutex> lk(queues[self].m);
+                if (!queues[self].dirs.empty())
+                {
+                    dir = std::move(queues[self].dirs.back());
+                    queues[self].dirs.pop_back();
+                    return true;
+                }
+            }
+            for (std::size_t k = 1; k < queues.size(); ++k)
+            {
+                work_queue &victim = queues[(self + k) % queues.size()];
+                std::lock_guard<std::mutex> lk(victim.m);
+                if (!victim.dirs.empty())
+                {
+                    dir = std::move(victim.dirs.front());
+                    victim.dirs.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void read_dir(std::size_t self, const dir_task &dir, dirent_batch &batch,
+                      std::string &path)
+        {
+            const int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+            int fd = dir.parent
+                         ? ::openat(dir.parent->fd, dir.path.c_str() + dir.name, flags | O_NOFOLLOW)
+                         : ::open(dir.path.c_str(), flags);
+            dir_handle d(fd < 0 ? nullptr : ::fdopendir(fd)); // closed on every exit
+            if (d == nullptr)
+            {
+                if (fd >= 0)
+                    ::close(fd);
+                errors.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            // list the whole directory first, then stat the batch against the open fd
+            batch.names.clear();
+            batch.items.clear();
+            int read_error = 0;
+            for (;;)
+            {
+                errno = 0; // readdir() returns nullptr both at the end and on an error
+                dirent *e = ::readdir(d.get());
+                if (e == nullptr)
+                {
+                    read_error = errno;
+                    break;
+                }
+                std::string_view name(e->d_name);
+                if (name == "." || name == "..")
+                    continue;
+                batch.items.emplace_back(batch.names.size(), e->d_type);
+                batch.names.insert(batch.names.end(), name.begin(), name.end());
+                batch.names.push_back('\0');
+            }
+
+            (read_error ? errors : directories).fetch_add(1, std::memory_order_relaxed);
+
+            path.assign(dir.path);
+            if (path.back() != '/')
+                path.push_back('/');
+            const std::size_t prefix = path.size();
+            std::shared_ptr<const unique_fd> self_fd; // shared by the subdirectories queued
+            for (const auto &[offset, d_type] : batch.items)
+            {
+                if (stopped.load(std::memory_order_relaxed))
+                    return;
+                const char *name = batch.names.data() + offset;
+                walk_entry entry{{}, from_d_type(d_type), 0, 0};
+                if (options.stat || entry.type == std::filesystem::file_type::unknown)
+                {
+                    struct statx sx;
+                    unsigned mask = STATX_TYPE;
+                    if (options.stat)
+                        mask |= STATX_SIZE | STATX_MTIME;
+                    if (::statx(::dirfd(d.get()), name, AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, mask,
+                                &sx) == 0)
+                    {
+                        entry.type = from_mode(sx.stx_mode);
+                        entry.size = options.stat ? sx.stx_size : 0;
+                        entry.mtime_ns = options.stat ? sx.stx_mtime.tv_sec * 1000000000LL +
+                                                            sx.stx_mtime.tv_nsec
+                                                      : 0;
+                    }
+                }
+                path.resize(prefix);
+                path.append(name);
+                entry.path = path;
+                callback(static_cast<const walk_entry &>(entry));
+                entries.fetch_add(1, std::memory_order_relaxed);
+                if (entry.type == std::filesystem::file_type::directory)
+                {
+                    // a duplicate, as `d` is closed when this call returns
+                    if (!self_fd)
+                        self_fd = std::make_shared<const unique_fd>(::dup(::dirfd(d.get())));
+                    push(self, dir_task{self_fd->fd >= 0 ? self_fd : nullptr, path, prefix});
+                }
+            }
+        }
+
+        void fail(std::exception_ptr e)
+        {
+            {
+                std::lock_guard<std::mutex> lk(error_m);
+                if (!error)
+                    error = std::move(e);
+            }
+            stopped.store(true, std::memory_order_relaxed);
+        }
+
+        void work(std::size_t self)
+        {
+            dirent_batch batch;
+            dir_task dir;
+            std::string path;
+            unsigned idle = 0;
+            while (!stopped.load(std::memory_order_relaxed))
+            {
+                if (pop(self, dir))
+                {
+                    idle = 0;
+                    try
+                    {
+                        read_dir(self, dir, batch, path);
+                    }
+                    catch (...)
+                    {
+                        fail(std::current_exception());
+                    }
+                    pending.fetch_sub(1, std::memory_order_acq_rel);
+                }
+                else if (pending.load(std::memory_order_acquire) == 0)
+                    return;
+                else if (++idle > 16)
+                    std::this_thread::yield();
+            }
+        }
+
+    public:
+        walker(Callback &callback, const walk_options &options)
+            : callback(callback), options(options),
+              queues(options.threads == 0 ? 1 : options.threads) {}
+
+        walk_stats run(const std::string &root)
+        {
+            push(0, dir_task{nullptr, root});
+            std::vector<std::thread> pool;
+            for (std::size_t i = 1; i < queues.size(); ++i)
+                pool.emplace_back([this, i]
+                                  { work(i); });
+            work(0);
+            for (auto &t : pool)
+                t.join();
+            if (error)
+                std::rethrow_exception(error);
+            return walk_stats{entries.load(), directories.load(), errors.load()};
+        }
+    };
+}
+
+// calls callback(const walk_entry &) for every entry below `root`, not following symlinks
+template <typename Callback>
+walk_stats parallel_walk(const std::filesystem::path &root, Callback &&callback,
+                         const walk_options &options = walk_options{})
+{
+    dir_walker_detail::walker<std::remove_reference_t<Callback>> w(callback, options);
+    return w.run(root.string());
+}
+
+#endif
@@ -0,0 +1,316 @@
+/**
+ * copy, fill, find and count that pick their loop from the iterator and value type at compile
+ * time. Requires C++20.
+ *
+ * Each algorithm is an overload set constrained by concepts, and overload resolution takes
+ * the most constrained candidate:
+ * - contiguous memory of trivially copyable (copy) or scalar (fill, find, count) values runs
+ *   on raw pointers: memmove, memset and memchr where they apply, otherwise plain indexed
+ *   loops the compiler vectorizes;
+ * - other random-access iterators run a counted loop unrolled into fixed-size blocks, with no
+ *   `first != last` test per element;
+ * - anything else (e.g. list or stream iterators) takes the usual element-by-element loop.
+ * The three bodies are also callable directly from dispatch_algos_detail, which is how the
+ * benchmarks compare them.
+ */
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#ifndef __DISPATCH_ALGOS_HPP__
+#define __DISPATCH_ALGOS_HPP__
+
+// contiguous ranges of one trivially copyable type, so a copy can be a memmove
+template <typename I, typename O>
+concept memmove_copyable =
+    std::contiguous_iterator<I> && std::contiguous_iterator<O> &&
+    std::same_as<std::iter_value_t<I>, std::iter_value_t<O>> &&
+    std::indirectly_writable<O, std::iter_reference_t<I>> &&
+    std::is_trivially_copyable_v<std::iter_value_t<I>>;
+
+// contiguous arithmetic, enum or pointer values: compared and assigned by single instructions
+template <typename I>
+concept contiguous_scalars =
+    std::contiguous_iterator<I> && std::is_scalar_v<std::iter_value_t<I>>;
+
+namespace dispatch_algos_detail
+{
+    // elements per step of the blocked loops: enough to hide the loop overhead, few enough
+    // that the unrolled body stays small
+    constexpr std::ptrdiff_t block = 8;
+
+    template <typename T>
+    constexpr bool is_byte = sizeof(T) == 1 && std::is_integral_v<T>;
+
+    // an unsigned integer of the given width, up to eight bytes
+    template <std::size_t Bytes>
+    using lane_counter =
+        std::conditional_t<Bytes == 1, uint8_t,
+                           std::conditional_t<Bytes == 2, uint16_t,
+                                              std::conditional_t<Bytes == 4, uint32_t, uint64_t>>>;
+
+    // generic: one element at a time, for any input iterator
+
+    template <typename I, typename S, typename O>
+    O generic_copy(I first, S last, O out)
+    {
+        for (; first != last; ++first, ++out)
+            *out = *first;
+        return out;
+    }
+
+    template <typename I, typename S, typename T>
+    void generic_fill(I first, S last, const T &value)
+    {
+        for (; first != last; ++first)
+            *first = value;
+    }
+
+    template <typename I, typename S, typename T>
+    I generic_find(I first, S last, const T &value)
+    {
+        for (; first != last; ++first)
+            if (*first == value)
+                break;
+        return first;
+    }
+
+    template <typename I, typename S, typename T>
+    std::iter_difference_t<I> generic_count(I first, S last, const T &value)
+    {
+        std::iter_difference_t<I> n = 0;
+        for (; first != last; ++first)
+            n += *first == value;
+        return n;
+    }
+
+    // blocked: random-access iterators, walked in counted blocks; the trip count comes from
+    // one `last - first` up front, so the inner loop has a constant bound and unrolls, with no
+    // `first != last` test per element
+
+    template <typename I, typename O>
+    O blocked_copy(I first, I last, O out)
+    {
+        std::iter_difference_t<I> n = last - first;
+        for (; n >= block; n -= block)
+            for (std::ptrdiff_t k = 0; k < block; ++k, ++first, ++out)
+                *out = *first;
+        for (; n > 0; --n, ++first, ++out)
+            *out = *first;
+        return out;
+    }
+
+    template <typename I, typename T>
+    void blocked_fill(I first, I last, const T &value)
+    {
+        std::iter_difference_t<I> n = last - first;
+        for (; n >= block; n -= block)
+            for (std::ptrdiff_t k = 0; k < block; ++k, ++first)
+                *first = value;
+        for (; n > 0; --n, ++first)
+            *first = value;
+    }
+
+    template <typename I, typename T>
+    I blocked_find(I first, I last, const T &value)
+    {
+        std::iter_difference_t<I> n = last - first;
+        for (; n >= block; n -= block, first += block)
+        {
+            // test the whole block with no early exit, then locate the match if there is one
+            bool any = false;
+            I it = first;
+            for (std::ptrdiff_t k = 0; k < block; ++k, ++it)
+                any |= *it == value;
+            if (any)
+                break;
+        }
+        for (; first != last; ++first)
+            if (*first == value)
+                break;
+        return first;
+    }
+
+    template <typename I, typename T>
+    std::iter_difference_t<I> blocked_count(I first, I last, const T &value)
+    {
+        std::iter_difference_t<I> n = last - first, total = 0;
+        for (; n >= block; n -= block)
+        {
+            int hits = 0;
+            for (std::ptrdiff_t k = 0; k < block; ++k, ++first)
+                hits += *first == value;
+            total += hits;
+        }
+        for (; n > 0; --n, ++first)
+            total += *first == value;
+        return total;
+    }
+
+    // contiguous: raw pointers into the underlying array
+
+    template <typename I, typename O>
+    O contiguous_copy(I first, I last, O out)
+    {
+        std::size_t n = static_cast<std::size_t>(last - first);
+        if (n > 0) // memmove's pointers must be valid even for a zero count
+            std::memmove(std::to_address(out), std::to_address(first),
+                         n * sizeof(std::iter_value_t<I>));
+        return out + n;
+    }
+
+    template <typename I, typename T>
+    void contiguous_fill(I first, I last, const T &value)
+    {
+        using V = std::iter_value_t<I>;
+        V *p = std::to_address(first);
+        std::size_t n = static_cast<std::size_t>(last - first);
+        const V v = value; // the conversion `*first = value` would do, no more
+        if constexpr (is_byte<V>)
+            std::memset(p, static_cast<unsigned char>(v), n);
+        else
+            for (std::size_t i = 0; i < n; ++i)
+                p[i] = v;
+    }
+
+    template <typename I, typename T>
+    I contiguous_find(I first, I last, const T &value)
+    {
+        using V = std::iter_value_t<I>;
+        const V *p = std::to_address(first);
+        std::size_t n = static_cast<std::size_t>(last - first);
+        if constexpr (is_byte<V>)
+        {
+            // a value the byte type cannot hold can never be found
+            const V narrowed = value;
+            if (narrowed != value || n == 0)
+                return last;
+            const void *hit = std::memchr(p, static_cast<unsigned char>(value), n);
+            return hit ? first + (static_cast<const V *>(hit) - p) : last;
+        }
+        else
+        {
+            std::size_t i = 0;
+            for (; i + block <= n; i += block)
+            {
+                bool any = false;
+                for (std::ptrdiff_t k = 0; k < block; ++k)
+                    any |= p[i + k] == value;
+                if (any)
+                    break;
+            }
+            for (; i < n; ++i)
+                if (p[i] == value)
+                    return first + i;
+            return last;
+        }
+    }
+
+    template <typename I, typename T>
+    std::iter_difference_t<I> contiguous_count(I first, I last, const T &value)
+    {
+        using V = std::iter_value_t<I>;
+        const V *p = std::to_address(first);
+        std::size_t n = static_cast<std::size_t>(last - first), total = 0;
+        // count into a counter as wide as the elements, 255 elements at a time, so the
+        // vectorized compares add up in full-width lanes without widening to 64 bits first
+        using counter = lane_counter<sizeof(V)>;
+        constexpr std::size_t chunk = 255;
+        for (std::size_t i = 0; i < n; i += chunk)
+        {
+            std::size_t end = i + chunk < n ? i + chunk : n;
+            counter hits = 0;
+            for (std::size_t j = i; j < end; ++j)
+                hits += p[j] == value;
+            total += hits;
+        }
+        return static_cast<std::iter_difference_t<I>>(total);
+    }
+}
+
+template <std::input_iterator I, std::sentinel_for<I> S, std::weakly_incrementable O>
+    requires std::indirectly_copyable<I, O>
+O fast_copy(I first, S last, O out)
+{
+    return dispatch_algos_detail::generic_copy(first, last, out);
+}
+
+template <std::random_access_iterator I, std::weakly_incrementable O>
+    requires std::indirectly_copyable<I, O>
+O fast_copy(I first, I last, O out)
+{
+    return dispatch_algos_detail::blocked_copy(first, last, out);
+}
+
+template <std::random_access_iterator I, std::weakly_incrementable O>
+    requires std::indirectly_copyable<I, O> && memmove_copyable<I, O>
+O fast_copy(I first, I last, O out)
+{
+    return dispatch_algos_detail::contiguous_copy(first, last, out);
+}
+
+template <std::forward_iterator I, std::sentinel_for<I> S, typename T>
+    requires std::indirectly_writable<I, const T &>
+void fast_fill(I first, S last, const T &value)
+{
+    dispatch_algos_detail::generic_fill(first, last, value);
+}
+
+template <std::random_access_iterator I, typename T>
+    requires std::indirectly_writable<I, const T &>
+void fast_fill(I first, I last, const T &value)
+{
+    dispatch_algos_detail::blocked_fill(first, last, value);
+}
+
+template <std::random_access_iterator I, typename T>
+    requires std::indirectly_writable<I, const T &> && contiguous_scalars<I>
+void fast_fill(I first, I last, const T &value)
+{
+    dispatch_algos_detail::contiguous_fill(first, last, value);
+}
+
+template <std::input_iterator I, std::sentinel_for<I> S, typename T>
+I fast_find(I first, S last, const T &value)
+{
+    return dispatch_algos_detail::generic_find(first, last, value);
+}
+
+template <std::random_access_iterator I, typename T>
+I fast_find(I first, I last, const T &value)
+{
+    return dispatch_algos_detail::blocked_find(first, last, value);
+}
+
+template <std::random_access_iterator I, typename T>
+    requires contiguous_scalars<I>
+I fast_find(I first, I last, const T &value)
+{
+    return dispatch_algos_detail::contiguous_find(first, last, value);
+}
+
+template <std::input_iterator I, std::sentinel_for<I> S, typename T>
+std::iter_difference_t<I> fast_count(I first, S last, const T &value)
+{
+    return dispatch_algos_detail::generic_count(first, last, value);
+}
+
+template <std::random_access_iterator I, typename T>
+std::iter_difference_t<I> fast_count(I first, I last, const T &value)
+{
+    return dispatch_algos_detail::blocked_count(first, last, value);
+}
+
+template <std::random_access_iterator I, typename T>
+    requires contiguous_scalars<I>
+std::iter_difference_t<I> fast_count(I first, I last, const T &value)
+{
+    return dispatch_algos_detail::contiguous_count(first, last, value);
+}
+
+#endif
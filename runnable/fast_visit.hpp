@@ -0,0 +1,148 @@
+/**
+ * Drop-in alternative to std::visit whose codegen does not depend on how a given standard
+ * library happens to implement visitation. Requires C++17.
+ *
+ * Visiting a single variant with up to 64 alternatives compiles to one `switch` on index(),
+ * which compilers lower to a jump table with every case inlined. Visiting several variants
+ * at once (or one with more alternatives) goes through a compile-time generated table of
+ * function pointers indexed by the flattened alternative indices.
+ */
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#ifndef __FAST_VISIT_HPP__
+#define __FAST_VISIT_HPP__
+
+namespace fast_visit_detail
+{
+    template <typename T>
+    using remove_cvref_t = std::remove_cv_t<std::remove_reference_t<T>>;
+
+    template <typename V>
+    constexpr std::size_t alt_count = std::variant_size_v<remove_cvref_t<V>>;
+
+    // same rule as std::visit: the result type is taken from the all-zero-index combination
+    template <typename F, typename... Vs>
+    using result_t = std::invoke_result_t<F, decltype(std::get<0>(std::declval<Vs>()))...>;
+
+    ///////////////////////////////
+    // Single variant via switch //
+    ///////////////////////////////
+
+    constexpr std::size_t max_switch_cases = 64;
+
+#define FAST_VISIT_CASE(I)                                                           \
+    case I:                                                                          \
+        if constexpr (I < N)                                                         \
+            return std::invoke(std::forward<F>(f), std::get<I>(std::forward<V>(v))); \
+        else                                                                         \
+            break;
+#define FAST_VISIT_CASES_4(B) \
+    FAST_VISIT_CASE(B + 0)    \
+    FAST_VISIT_CASE(B + 1)    \
+    FAST_VISIT_CASE(B + 2)    \
+    FAST_VISIT_CASE(B + 3)
+#define FAST_VISIT_CASES_16(B) \
+    FAST_VISIT_CASES_4(B + 0)  \
+    FAST_VISIT_CASES_4(B + 4)  \
+    FAST_VISIT_CASES_4(B + 8)  \
+    FAST_VISIT_CASES_4(B + 12)
+
+    template <typename R, typename F, typename V>
+    R visit_switch(F &&f, V &&v)
+    {
+        constexpr std::size_t N = alt_count<V>;
+        static_assert(N <= max_switch_cases, "too many alternatives for the switch path");
+        switch (v.index())
+        {
+            FAST_VISIT_CASES_16(0)
+            FAST_VISIT_CASES_16(16)
+            FAST_VISIT_CASES_16(32)
+            FAST_VISIT_CASES_16(48)
+        default:
+            break;
+        }
+        // only reachable when the variant is valueless_by_exception
+        throw std::bad_variant_access();
+    }
+
+#undef FAST_VISIT_CASES_16
+#undef FAST_VISIT_CASES_4
+#undef FAST_VISIT_CASE
+
+    //////////////////////////////////////
+    // Any number of variants via table //
+    //////////////////////////////////////
+
+    // decodes the I-th (row-major) index out of a flattened index at compile time
+    template <std::size_t Flat, std::size_t I, typename... Vs>
+    constexpr std::size_t unflatten()
+    {
+        constexpr std::size_t sizes[] = {alt_count<Vs>...};
+        std::size_t stride = 1;
+        for (std::size_t k = I + 1; k < sizeof...(Vs); ++k)
+            stride *= sizes[k];
+        return (Flat / stride) % sizes[I];
+    }
+
+    template <typename R, typename F, typename... Vs, std::size_t... Is>
+    constexpr auto make_entry(std::index_sequence<Is...>)
+    {
+        return +[](F &&f, Vs &&...vs) -> R
+        {
+            return std::invoke(std::forward<F>(f), std::get<Is>(std::forward<Vs>(vs))...);
+        };
+    }
+
+    template <std::size_t Flat, typename R, typename F, typename... Vs, std::size_t... Ks>
+    constexpr auto entry_for(std::index_sequence<Ks...>)
+    {
+        return make_entry<R, F, Vs...>(std::index_sequence<unflatten<Flat, Ks, Vs...>()...>{});
+    }
+
+    template <typename R, typename F, typename... Vs, std::size_t... Flats>
+    constexpr auto make_multi_table(std::index_sequence<Flats...>)
+    {
+        using Entry = R (*)(F &&, Vs &&...);
+        return std::array<Entry, sizeof...(Flats)>{
+            entry_for<Flats, R, F, Vs...>(std::index_sequence_for<Vs...>{})...};
+    }
+
+    template <typename R, typename F, typename... Vs>
+    struct dispatch_table
+    {
+        static constexpr std::size_t size = (alt_count<Vs> * ... * 1);
+        static constexpr auto entries =
+            make_multi_table<R, F, Vs...>(std::make_index_sequence<size>{});
+    };
+
+    template <typename R, typename F, typename... Vs>
+    R visit_table(F &&f, Vs &&...vs)
+    {
+        if ((vs.valueless_by_exception() || ...))
+            throw std::bad_variant_access();
+        std::size_t flat = 0;
+        ((flat = flat * alt_count<Vs> + vs.index()), ...);
+        return dispatch_table<R, F, Vs...>::entries[flat](std::forward<F>(f),
+                                                          std::forward<Vs>(vs)...);
+    }
+}
+
+// visits one or more variants with `f`, with the same semantics as std::visit
+template <typename F, typename... Vs>
+decltype(auto) fast_visit(F &&f, Vs &&...vs)
+{
+    using namespace fast_visit_detail;
+    using R = result_t<F, Vs...>;
+    if constexpr (sizeof...(Vs) == 1 && (... && (alt_count<Vs> <= max_switch_cases)))
+        return visit_switch<R>(std::forward<F>(f), std::forward<Vs>(vs)...);
+    else
+        return visit_table<R>(std::forward<F>(f), std::forward<Vs>(vs)...);
+}
+
+#endif
@@ -0,0 +1,74 @@
+/**
+ * Locale-independent, allocation-free number formatting into caller buffers. Requires C++17.
+ *
+ * format_number() writes the shortest decimal text of a float or double that reads back to
+ * the exact same value (std::to_chars without a format; libstdc++ implements it with Ryu),
+ * so 1.2f becomes "1.2" where std::to_string gives "1.200000" and "%.17g" gives
+ * "1.2000000476837158". Integers take std::to_chars' two-digits-per-step path. Nothing goes
+ * through printf, a locale, or the heap: the text lands in a buffer the caller owns, at most
+ * max_chars<T> bytes long, which to_inline_string() and append_number() build on.
+ */
+
+#include <charconv>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include "inline_string.hpp"
+
+#ifndef __FORMAT_NUMBER_HPP__
+#define __FORMAT_NUMBER_HPP__
+
+namespace format_number_detail
+{
+    template <typename T>
+    constexpr std::size_t max_chars()
+    {
+        static_assert((std::is_integral_v<T> && !std::is_same_v<T, bool>) ||
+                          std::is_same_v<T, float> || std::is_same_v<T, double>,
+                      "integral, float or double T required");
+        using limits = std::numeric_limits<T>;
+        if constexpr (std::is_integral_v<T>)
+            return limits::digits10 + 1 + limits::is_signed;
+        else
+        {
+            // sign, significant digits, point, "e-" and the exponent digits; the fixed form
+            // is only chosen when it is shorter than that
+            std::size_t exponent_digits = limits::max_exponent10 >= 100 ? 3 : 2;
+            return 1 + limits::max_digits10 + 1 + 2 + exponent_digits;
+        }
+    }
+}
+
+// the longest text format_number() can produce for a T, e.g. 15 for float, 24 for double
+template <typename T>
+inline constexpr std::size_t max_chars = format_number_detail::max_chars<T>();
+
+// writes `value` into [first, last) and returns the end of the text, or nullptr if it does not
+// fit; floating-point values are written in the shortest form that round-trips
+template <typename T>
+char *format_number(char *first, char *last, T value)
+{
+    static_assert(max_chars<T> > 0); // rejects bool and long double
+    std::to_chars_result r = std::to_chars(first, last, value);
+    return r.ec == std::errc() ? r.ptr : nullptr;
+}
+
+// the formatted text stored inline in a fixed-size string, for keys and labels
+template <typename T>
+inline_string<max_chars<T>> to_inline_string(T value)
+{
+    char buf[max_chars<T>];
+    return std::string_view(buf, format_number(buf, buf + sizeof(buf), value) - buf);
+}
+
+// appends the formatted text to `out`, which only allocates when out runs out of capacity
+template <typename T>
+void append_number(std::string &out, T value)
+{
+    char buf[max_chars<T>];
+    out.append(buf, format_number(buf, buf + sizeof(buf), value));
+}
+
+#endif
@@ -0,0 +1,176 @@
+/**
+ * Allocation-free type-erased callables. Requires C++17.
+ *
+ * - function_ref<R(Args...)>: non-owning, two pointers wide (object + trampoline); the
+ *   referenced callable must outlive the function_ref, just like with std::string_view
+ * - inplace_function<R(Args...), N>: owning, stores the callable in an inline buffer of N
+ *   bytes and refuses (at compile time) callables that do not fit -- never allocates. Like
+ *   std::function, it only accepts copyable callables, and a const inplace_function still
+ *   calls its target as a non-const lvalue, so mutable lambdas keep working
+ */
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifndef __FUNCTION_REF_HPP__
+#define __FUNCTION_REF_HPP__
+
+//////////////////
+// function_ref //
+//////////////////
+
+template <typename Signature>
+class function_ref;
+
+template <typename R, typename... Args>
+class function_ref<R(Args...)>
+{
+    // callable objects are referenced by address; free functions are stored by value so
+    // that `function_ref f = &func;` does not dangle
+    union storage
+    {
+        void *obj;
+        void (*fn)();
+    };
+
+    storage ref;
+    R (*call)(storage, Args...);
+
+public:
+    template <typename F, typename D = std::remove_reference_t<F>,
+              typename = std::enable_if_t<!std::is_same_v<std::remove_cv_t<D>, function_ref> &&
+                                          std::is_invocable_r_v<R, F &, Args...>>>
+    function_ref(F &&f) noexcept
+    {
+        if constexpr (std::is_function_v<std::remove_pointer_t<D>>)
+        {
+            using Fn = std::add_pointer_t<std::remove_pointer_t<D>>;
+            ref.fn = reinterpret_cast<void (*)()>(static_cast<Fn>(f));
+            call = [](storage s, Args... args) -> R
+            { return std::invoke(reinterpret_cast<Fn>(s.fn), std::forward<Args>(args)...); };
+        }
+        else
+        {
+            ref.obj = const_cast<void *>(static_cast<const void *>(std::addressof(f)));
+            call = [](storage s, Args... args) -> R
+            { return std::invoke(*static_cast<D *>(s.obj), std::forward<Args>(args)...); };
+        }
+    }
+
+    function_ref(const function_ref &) noexcept = default;
+    function_ref &operator=(const function_ref &) noexcept = default;
+
+    R operator()(Args... args) const
+    {
+        return call(ref, std::forward<Args>(args)...);
+    }
+};
+
+//////////////////////
+// inplace_function //
+//////////////////////
+
+template <typename Signature, std::size_t Capacity = 32>
+class inplace_function;
+
+template <typename R, typename... Args, std::size_t Capacity>
+class inplace_function<R(Args...), Capacity>
+{
+    // one static table per stored callable type, so the object itself only carries a pointer
+    struct ops_t
+    {
+        R (*call)(void *, Args...);
+        void (*copy)(void *dst, const void *src);
+        void (*move)(void *dst, void *src) noexcept;
+        void (*destroy)(void *) noexcept;
+    };
+
+    template <typename F>
+    static constexpr ops_t ops_for{
+        [](void *o, Args... args) -> R
+        { return std::invoke(*static_cast<F *>(o), std::forward<Args>(args)...); },
+        [](void *dst, const void *src)
+        { ::new (dst) F(*static_cast<const F *>(src)); },
+        [](void *dst, void *src) noexcept
+        { ::new (dst) F(std::move(*static_cast<F *>(src))); },
+        [](void *o) noexcept
+        { static_cast<F *>(o)->~F(); },
+    };
+
+    // mutable: operator() is const, but the stored callable is invoked as non-const
+    alignas(std::max_align_t) mutable unsigned char buf[Capacity];
+    const ops_t *ops = nullptr;
+
+    // what the constructor requires of a callable, as constraints rather than static_asserts
+    // so that std::is_constructible and overload resolution see them
+    template <typename D>
+    static constexpr bool storable =
+        sizeof(D) <= Capacity && alignof(D) <= alignof(std::max_align_t) &&
+        std::is_copy_constructible_v<D> && std::is_nothrow_move_constructible_v<D>;
+
+public:
+    inplace_function() noexcept = default;
+
+    template <typename F, typename D = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same_v<D, inplace_function> &&
+                                          std::is_invocable_r_v<R, D &, Args...> &&
+                                          storable<D>>>
+    inplace_function(F &&f)
+    {
+        ::new (static_cast<void *>(buf)) D(std::forward<F>(f));
+        ops = &ops_for<D>;
+    }
+
+    inplace_function(const inplace_function &o) : ops(o.ops)
+    {
+        if (ops)
+            ops->copy(buf, o.buf);
+    }
+    inplace_function(inplace_function &&o) noexcept : ops(o.ops)
+    {
+        if (ops)
+            ops->move(buf, o.buf);
+    }
+    inplace_function &operator=(const inplace_function &o)
+    {
+        if (this != &o)
+        {
+            inplace_function tmp(o);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+    inplace_function &operator=(inplace_function &&o) noexcept
+    {
+        if (this == &o)
+            return *this;
+        reset();
+        ops = o.ops;
+        if (ops)
+            ops->move(buf, o.buf);
+        return *this;
+    }
+    ~inplace_function() { reset(); }
+
+    void reset() noexcept
+    {
+        if (ops)
+            ops->destroy(buf);
+        ops = nullptr;
+    }
+
+    explicit operator bool() const noexcept { return ops != nullptr; }
+
+    R operator()(Args... args) const
+    {
+        if (!ops)
+            throw std::bad_function_call();
+        return ops->call(buf, std::forward<Args>(args)...);
+    }
+};
+
+#endif
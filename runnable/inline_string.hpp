@@ -0,0 +1,87 @@
+/**
+ * Fixed-capacity string that never allocates. Requires C++17.
+ *
+ * inline_string<N> stores up to N characters plus a NUL terminator inline, with the length in
+ * one trailing byte, so the whole object is trivially copyable (a copy is a memcpy) and fits
+ * in N + 2 bytes. Going over capacity throws std::length_error, like std::string does when
+ * exceeding max_size(). Converts implicitly to std::string_view.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#ifndef __INLINE_STRING_HPP__
+#define __INLINE_STRING_HPP__
+
+template <std::size_t N>
+class inline_string
+{
+    static_assert(N <= 255, "inline_string length must fit in one byte");
+
+    char buf[N + 1] = {};
+    uint8_t len = 0;
+
+public:
+    constexpr inline_string() = default;
+    constexpr inline_string(std::string_view sv) { append(sv); }
+    constexpr inline_string(const char *s) : inline_string(std::string_view(s)) {}
+
+    static constexpr std::size_t capacity() { return N; }
+    constexpr std::size_t size() const { return len; }
+    constexpr bool empty() const { return len == 0; }
+    constexpr const char *data() const { return buf; }
+    constexpr const char *c_str() const { return buf; }
+    constexpr char operator[](std::size_t i) const { return buf[i]; }
+    constexpr char &operator[](std::size_t i) { return buf[i]; }
+
+    constexpr operator std::string_view() const { return std::string_view(buf, len); }
+    constexpr std::string_view view() const { return std::string_view(buf, len); }
+
+    constexpr void clear()
+    {
+        len = 0;
+        buf[0] = '\0';
+    }
+
+    constexpr inline_string &append(std::string_view sv)
+    {
+        if (sv.size() > N - len)
+            throw std::length_error("inline_string capacity exceeded");
+        for (std::size_t i = 0; i < sv.size(); ++i)
+            buf[len + i] = sv[i];
+        len = static_cast<uint8_t>(len + sv.size());
+        buf[len] = '\0';
+        return *this;
+    }
+
+    constexpr inline_string &push_back(char c)
+    {
+        return append(std::string_view(&c, 1));
+    }
+
+    constexpr inline_string &operator+=(std::string_view sv) { return append(sv); }
+    constexpr inline_string &operator+=(char c) { return push_back(c); }
+
+    // comparisons go through string_view, so mixing with std::string or literals just works
+    friend constexpr bool operator==(const inline_string &a, std::string_view b) { return a.view() == b; }
+    friend constexpr bool operator!=(const inline_string &a, std::string_view b) { return a.view() != b; }
+    friend constexpr bool operator<(const inline_string &a, std::string_view b) { return a.view() < b; }
+};
+
+namespace std
+{
+    template <std::size_t N>
+    struct hash<inline_string<N>>
+    {
+        std::size_t operator()(const inline_string<N> &s) const noexcept
+        {
+            return std::hash<std::string_view>{}(s.view());
+        }
+    };
+}
+
+#endif
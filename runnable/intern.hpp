@@ -0,0 +1,96 @@
+/**
+ * Compile-time string interning. Requires C++20.
+ *
+ * - interned / "..."_sid: a string literal paired with its 64-bit FNV-1a hash, computed by an
+ *   immediate function; equality compares only the hash, so it is a single integer compare.
+ *   IDs are stable across translation units and builds, with no registry needed.
+ * - string_table<N>: a fixed set of strings given dense IDs 0..N-1 at compile time, with
+ *   duplicate (or hash-colliding) entries rejected at compile time and id -> name lookup.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+#ifndef __INTERN_HPP__
+#define __INTERN_HPP__
+
+constexpr uint64_t fnv1a_64(std::string_view s)
+{
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (char c : s)
+    {
+        h ^= static_cast<unsigned char>(c);
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+/////////////////////
+// Hashed literals //
+/////////////////////
+
+struct interned
+{
+    uint64_t id;
+    std::string_view str; // points at the literal, which has static storage duration
+
+    constexpr bool operator==(const interned &o) const { return id == o.id; }
+};
+
+consteval interned intern(std::string_view s)
+{
+    return interned{fnv1a_64(s), s};
+}
+
+namespace intern_literals
+{
+    consteval interned operator"" _sid(const char *s, std::size_t len)
+    {
+        return intern(std::string_view(s, len));
+    }
+}
+
+//////////////////
+// Dense tables //
+//////////////////
+
+template <std::size_t N>
+class string_table
+{
+    std::array<std::string_view, N> names;
+    std::array<uint64_t, N> hashes;
+
+public:
+    template <typename... Names>
+    consteval string_table(Names... ns) : names{std::string_view(ns)...}, hashes{}
+    {
+        static_assert(sizeof...(Names) == N, "wrong number of names");
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            hashes[i] = fnv1a_64(names[i]);
+            for (std::size_t j = 0; j < i; ++j)
+                if (hashes[j] == hashes[i])
+                    throw std::invalid_argument("duplicate or colliding name in string_table");
+        }
+    }
+
+    // dense ID of `name`; a name that is not in the table does not compile
+    consteval uint32_t id(std::string_view name) const
+    {
+        for (std::size_t i = 0; i < N; ++i)
+            if (names[i] == name)
+                return static_cast<uint32_t>(i);
+        throw std::invalid_argument("name not in string_table");
+    }
+
+    constexpr std::string_view name(uint32_t id) const { return names[id]; }
+    static constexpr std::size_t size() { return N; }
+};
+
+template <typename... Names>
+string_table(Names...) -> string_table<sizeof...(Names)>;
+
+#endif
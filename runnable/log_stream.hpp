@@ -0,0 +1,212 @@
+/**
+ * Buffered, allocation-free output for the test and benchmark harness. Requires only C++11,
+ * like utils.hpp, and a POSIX write().
+ *
+ * - log_sink: a file descriptor plus one fixed 64 KiB buffer, written out in large blocks when
+ *   it fills up, on flush() and at exit -- instead of a write() per std::endl. When the fd is
+ *   a terminal it writes through right away, so interactive runs still show progress live.
+ * - log_line: the analogue of C++20 std::osyncstream. It formats into its own fixed buffer
+ *   and hands the whole text to the sink in one locked append when it goes out of scope, so
+ *   lines written by concurrent threads never interleave. Integers are formatted by hand (or
+ *   by std::to_chars under C++17), never through a locale or an allocation.
+ *
+ * RUN_EXAMPLE and RUN_BENCH flush the sink before each test or benchmark, so the name of one
+ * that crashes is never left in the buffer; the large buffer is for what runs in between.
+ * A line longer than log_line::capacity is passed on in several appends and may interleave.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <type_traits>
+
+#include <errno.h>
+#include <unistd.h>
+
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+
+#ifndef __LOG_STREAM_HPP__
+#define __LOG_STREAM_HPP__
+
+class log_sink
+{
+public:
+    static const std::size_t capacity = 64 * 1024;
+
+private:
+    std::mutex m;
+    int fd;
+    bool interactive;
+    std::size_t len;
+    char buf[capacity];
+
+    void write_all(const char *data, std::size_t n)
+    {
+        while (n > 0)
+        {
+            ssize_t w = ::write(fd, data, n);
+            if (w < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return; // nowhere to report a failing log; drop it like stdio would
+            }
+            data += w;
+            n -= static_cast<std::size_t>(w);
+        }
+    }
+
+    void flush_locked()
+    {
+        write_all(buf, len);
+        len = 0;
+    }
+
+public:
+    explicit log_sink(int fd) : fd(fd), interactive(::isatty(fd) == 1), len(0) {}
+    ~log_sink() { flush(); }
+
+    void write(const char *data, std::size_t n)
+    {
+        std::lock_guard<std::mutex> lk(m);
+        if (len + n > capacity)
+            flush_locked();
+        if (n >= capacity)
+            write_all(data, n); // too big to be worth copying
+        else
+        {
+            std::memcpy(buf + len, data, n);
+            len += n;
+        }
+        if (interactive)
+            flush_locked();
+    }
+
+    void flush()
+    {
+        std::lock_guard<std::mutex> lk(m);
+        flush_locked();
+    }
+};
+
+// the harness's standard output; lives until exit, when it flushes what is left
+inline log_sink &log_out()
+{
+    static log_sink sink(STDOUT_FILENO);
+    return sink;
+}
+
+namespace log_stream_detail
+{
+    // writes the decimal digits of v backwards, ending at `end`; returns the first char
+    inline char *format_unsigned(char *end, unsigned long long v)
+    {
+        do
+        {
+            *--end = static_cast<char>('0' + v % 10);
+            v /= 10;
+        } while (v != 0);
+        return end;
+    }
+}
+
+// writes `v` with `precision` digits after the point into buf; returns the length
+inline std::size_t format_fixed(char *buf, std::size_t size, double v, int precision)
+{
+#if __cplusplus >= 201703L
+    std::to_chars_result r = std::to_chars(buf, buf + size, v, std::chars_format::fixed, precision);
+    return r.ec == std::errc() ? static_cast<std::size_t>(r.ptr - buf) : 0;
+#else
+    int n = std::snprintf(buf, size, "%.*f", precision, v);
+    return n < 0 ? 0 : std::min(static_cast<std::size_t>(n), size - 1);
+#endif
+}
+
+class log_line
+{
+public:
+    static const std::size_t capacity = 1024;
+
+private:
+    log_sink &sink;
+    std::size_t len;
+    char buf[capacity];
+
+    void spill()
+    {
+        sink.write(buf, len);
+        len = 0;
+    }
+
+public:
+    explicit log_line(log_sink &sink = log_out()) : sink(sink), len(0) {}
+    log_line(const log_line &) = delete;
+    log_line &operator=(const log_line &) = delete;
+    ~log_line() { emit(); }
+
+    // hands everything written so far to the sink in one piece
+    void emit()
+    {
+        if (len > 0)
+            spill();
+    }
+
+    log_line &append(const char *data, std::size_t n)
+    {
+        while (n > 0)
+        {
+            if (len == capacity)
+                spill();
+            std::size_t k = n < capacity - len ? n : capacity - len;
+            std::memcpy(buf + len, data, k);
+            len += k;
+            data += k;
+            n -= k;
+        }
+        return *this;
+    }
+
+    log_line &fill(char c, std::size_t n)
+    {
+        while (n-- > 0)
+            append(&c, 1);
+        return *this;
+    }
+
+    log_line &operator<<(const char *s) { return append(s, std::strlen(s)); }
+    log_line &operator<<(const std::string &s) { return append(s.data(), s.size()); }
+    log_line &operator<<(char c) { return append(&c, 1); }
+    log_line &operator<<(bool b) { return b ? append("true", 4) : append("false", 5); }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value, log_line &>::type operator<<(T v)
+    {
+        char tmp[24];
+#if __cplusplus >= 201703L
+        std::to_chars_result r = std::to_chars(tmp, tmp + sizeof(tmp), v);
+        return append(tmp, static_cast<std::size_t>(r.ptr - tmp));
+#else
+        char *end = tmp + sizeof(tmp);
+        unsigned long long u = static_cast<unsigned long long>(v);
+        bool negative = std::is_signed<T>::value && v < 0;
+        char *p = log_stream_detail::format_unsigned(end, negative ? 0 - u : u);
+        if (negative)
+            *--p = '-';
+        return append(p, static_cast<std::size_t>(end - p));
+#endif
+    }
+
+    // six digits after the point, like std::to_string(double)
+    log_line &operator<<(double v)
+    {
+        char tmp[320]; // DBL_MAX has 309 integer digits
+        return append(tmp, format_fixed(tmp, sizeof(tmp), v, 6));
+    }
+};
+
+#endif
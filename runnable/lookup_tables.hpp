@@ -0,0 +1,152 @@
+/**
+ * Compile-time generated combinatorics tables. Requires C++20 (and GCC/Clang for __int128).
+ *
+ * Every table is built by a consteval function into a constexpr std::array, so a run-time
+ * lookup is a single indexed load. Arithmetic is overflow-checked while the table is being
+ * built: asking for an entry that does not fit in T is a compile error, not a wrapped value.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#ifndef __LOOKUP_TABLES_HPP__
+#define __LOOKUP_TABLES_HPP__
+
+namespace lookup_tables_detail
+{
+    // std::numeric_limits is not specialized for __int128 in strict (non-GNU) modes
+    template <typename T>
+    consteval T max_of()
+    {
+        if constexpr (std::numeric_limits<T>::is_specialized)
+            return std::numeric_limits<T>::max();
+        else if constexpr (static_cast<T>(-1) > static_cast<T>(0))
+            return static_cast<T>(~static_cast<T>(0));
+        else
+            return static_cast<T>(~static_cast<unsigned __int128>(0) >> 1);
+    }
+
+    // non-negative operands only -- all tables here are of non-negative sequences
+    template <typename T>
+    consteval T checked_add(T a, T b)
+    {
+        if (a > max_of<T>() - b)
+            throw std::overflow_error("table entry overflows its type");
+        return a + b;
+    }
+
+    template <typename T>
+    consteval T checked_mul(T a, T b)
+    {
+        if (a != 0 && b > max_of<T>() / a)
+            throw std::overflow_error("table entry overflows its type");
+        return a * b;
+    }
+}
+
+///////////////
+// Factorial //
+///////////////
+
+// {0!, 1!, ..., (N-1)!}
+template <typename T, std::size_t N>
+consteval std::array<T, N> factorial_table()
+{
+    std::array<T, N> t{};
+    T f = 1;
+    for (std::size_t n = 0; n < N; ++n)
+    {
+        if (n > 0)
+            f = lookup_tables_detail::checked_mul(f, static_cast<T>(n));
+        t[n] = f;
+    }
+    return t;
+}
+
+// largest n such that n! fits in T
+template <typename T>
+consteval std::size_t max_factorial_n()
+{
+    T f = 1;
+    std::size_t n = 1;
+    while (f <= lookup_tables_detail::max_of<T>() / static_cast<T>(n + 1))
+        f *= static_cast<T>(++n);
+    return n;
+}
+
+template <typename T>
+inline constexpr auto factorials = factorial_table<T, max_factorial_n<T>() + 1>();
+
+// n! as one load from a compile-time table; n must be <= max_factorial_n<T>()
+template <typename T = uint64_t>
+constexpr T factorial_lookup(std::size_t n)
+{
+    return factorials<T>[n];
+}
+
+///////////////////////////
+// Binomial coefficients //
+///////////////////////////
+
+// Pascal's triangle: t[n][k] = C(n, k) for n, k < N (zero when k > n)
+template <typename T, std::size_t N>
+consteval std::array<std::array<T, N>, N> binomial_table()
+{
+    std::array<std::array<T, N>, N> t{};
+    for (std::size_t n = 0; n < N; ++n)
+    {
+        t[n][0] = 1;
+        for (std::size_t k = 1; k <= n; ++k)
+            t[n][k] = lookup_tables_detail::checked_add(t[n - 1][k - 1], t[n - 1][k]);
+    }
+    return t;
+}
+
+// largest n such that every C(n, k) fits in T
+template <typename T>
+consteval std::size_t max_binomial_n()
+{
+    // build Pascal rows in place until an addition would overflow
+    std::array<T, 256> row{};
+    row[0] = 1;
+    for (std::size_t n = 1; n < row.size(); ++n)
+    {
+        for (std::size_t k = n; k > 0; --k)
+        {
+            if (row[k - 1] > lookup_tables_detail::max_of<T>() - row[k])
+                return n - 1;
+            row[k] += row[k - 1];
+        }
+    }
+    return row.size() - 1;
+}
+
+template <typename T>
+inline constexpr auto binomials = binomial_table<T, max_binomial_n<T>() + 1>();
+
+// C(n, k) as one load from a compile-time table; n must be <= max_binomial_n<T>()
+template <typename T = uint64_t>
+constexpr T binomial_lookup(std::size_t n, std::size_t k)
+{
+    return binomials<T>[n][k];
+}
+
+/////////////////////////
+// Fibonacci sequences //
+/////////////////////////
+
+// {a0, a1, a0 + a1, ...} -- e.g. Fibonacci with a0 = 0, a1 = 1
+template <typename T, std::size_t N>
+consteval std::array<T, N> fibonacci_table(T a0 = 0, T a1 = 1)
+{
+    std::array<T, N> t{};
+    for (std::size_t n = 0; n < N; ++n)
+        t[n] = n == 0 ? a0 : n == 1 ? a1 : lookup_tables_detail::checked_add(t[n - 1], t[n - 2]);
+    return t;
+}
+
+#endif
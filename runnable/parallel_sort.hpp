@@ -0,0 +1,256 @@
+/**
+ * Sorting large arrays beyond plain std::sort, over std::span. Requires C++20.
+ *
+ * - radix_sort: LSD radix sort on 8-bit digits for integral keys; all digit histograms come
+ *   from one counting pass, and passes whose digit is the same for every key are skipped.
+ *   bool is not a radix key (it has no unsigned counterpart); sort it with std::sort
+ * - parallel_merge_sort: each thread std::sort's one run, then the runs are cut at the
+ *   co-ranks of equal-sized output slices (found by binary search, with equal keys divided
+ *   by position) and every thread k-way merges its own slice, so both phases scale with the
+ *   thread count, even on inputs full of duplicates, and the merge needs no serial step
+ */
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#ifndef __PARALLEL_SORT_HPP__
+#define __PARALLEL_SORT_HPP__
+
+////////////////
+// Radix sort //
+////////////////
+
+// integers with a byte-wise digit decomposition; bool has no unsigned counterpart
+template <typename T>
+concept radix_key = std::integral<T> && !std::same_as<std::remove_cv_t<T>, bool>;
+
+template <radix_key T, std::size_t Extent>
+void radix_sort(std::span<T, Extent> data)
+{
+    using U = std::make_unsigned_t<T>;
+    constexpr std::size_t digits = sizeof(T);
+    // flipping the sign bit maps signed order onto unsigned order
+    constexpr U flip = std::is_signed_v<T> ? static_cast<U>(U{1} << (8 * sizeof(T) - 1)) : U{0};
+    const std::size_t n = data.size();
+    if (n < 2)
+        return;
+
+    std::vector<std::array<std::size_t, 256>> hist(digits);
+    for (T v : data)
+    {
+        U u = static_cast<U>(v) ^ flip;
+        for (std::size_t d = 0; d < digits; ++d)
+            ++hist[d][(u >> (8 * d)) & 0xFF];
+    }
+
+    std::vector<T> scratch(n);
+    std::span<T> src = data, dst = scratch;
+    for (std::size_t d = 0; d < digits; ++d)
+    {
+        auto &h = hist[d];
+        U first = (static_cast<U>(src[0]) ^ flip) >> (8 * d) & 0xFF;
+        if (h[first] == n)
+            continue; // every key has the same digit here
+        std::size_t offset = 0;
+        for (auto &c : h)
+        {
+            std::size_t count = c;
+            c = offset;
+            offset += count;
+        }
+        for (T v : src)
+            dst[h[((static_cast<U>(v) ^ flip) >> (8 * d)) & 0xFF]++] = v;
+        std::swap(src, dst);
+    }
+    if (src.data() != data.data())
+        std::copy(src.begin(), src.end(), data.begin());
+}
+
+/////////////////////////
+// Parallel merge sort //
+/////////////////////////
+
+namespace parallel_sort_detail
+{
+    // moves the sorted ranges `runs` into `out` in order, using a binary heap of run cursors;
+    // `out` holds constructed (moved-from) elements that are assigned over
+    template <typename T, typename Compare>
+    void multiway_merge(std::vector<std::span<T>> runs, T *out, Compare &comp)
+    {
+        std::erase_if(runs, [](const auto &r)
+                      { return r.empty(); });
+        // heap ordered so the run with the smallest head is at the front
+        auto later = [&](const std::span<T> &a, const std::span<T> &b)
+        { return comp(b.front(), a.front()); };
+        std::make_heap(runs.begin(), runs.end(), later);
+        while (runs.size() > 1)
+        {
+            std::pop_heap(runs.begin(), runs.end(), later);
+            auto &r = runs.back();
+            *out++ = std::move(r.front());
+            r = r.subspan(1);
+            if (r.empty())
+                runs.pop_back();
+            else
+                std::push_heap(runs.begin(), runs.end(), later);
+        }
+        if (!runs.empty())
+            std::move(runs[0].begin(), runs[0].end(), out);
+    }
+
+    // co-ranks of output position k: cut[r] elements of each sorted run r such that the cuts
+    // add up to k and together hold the k smallest elements. Elements equal to the one of
+    // rank k are divided by position, earlier runs first, so any number of duplicates still
+    // splits evenly
+    template <typename T, typename Compare>
+    std::vector<std::size_t> co_ranks(const std::vector<std::span<T>> &runs, std::size_t k,
+                                      Compare &comp)
+    {
+        const std::size_t count = runs.size();
+        std::vector<std::size_t> lo(count), hi(count), cut(count, 0);
+        auto count_less = [&](const T &v)
+        {
+            std::size_t less = 0;
+            for (const auto &run : runs)
+                less += std::lower_bound(run.begin(), run.end(), v, comp) - run.begin();
+            return less;
+        };
+        for (const auto &run : runs)
+        {
+            // the last element of this run with at most k elements smaller than it; if the
+            // element of rank k is in this run, that is it or one equal to it
+            std::size_t a = 0, b = run.size();
+            while (a < b)
+            {
+                std::size_t mid = a + (b - a) / 2;
+                if (count_less(run[mid]) <= k)
+                    a = mid + 1;
+                else
+                    b = mid;
+            }
+            if (a == 0)
+                continue;
+            const T &v = run[a - 1];
+            std::size_t less = 0, less_equal = 0;
+            for (std::size_t r = 0; r < count; ++r)
+            {
+                lo[r] = std::lower_bound(runs[r].begin(), runs[r].end(), v, comp) - runs[r].begin();
+                hi[r] = std::upper_bound(runs[r].begin(), runs[r].end(), v, comp) - runs[r].begin();
+                less += lo[r];
+                less_equal += hi[r];
+            }
+            if (k < less || k >= less_equal)
+                continue;
+            std::size_t ties = k - less;
+            for (std::size_t r = 0; r < count; ++r)
+            {
+                std::size_t take = std::min(ties, hi[r] - lo[r]);
+                cut[r] = lo[r] + take;
+                ties -= take;
+            }
+            return cut;
+        }
+        // k is past the last element
+        for (std::size_t r = 0; r < count; ++r)
+            cut[r] = runs[r].size();
+        return cut;
+    }
+
+    // runs task(i) for i in [0, count) on threads of their own; the first exception any of
+    // them throws is rethrown once all have finished
+    template <typename Task>
+    void run_workers(unsigned count, Task &&task)
+    {
+        std::vector<std::exception_ptr> errors(count);
+        std::vector<std::thread> workers;
+        auto guarded = [&](unsigned i)
+        {
+            try
+            {
+                task(i);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        };
+        try
+        {
+            for (unsigned i = 0; i < count; ++i)
+                workers.emplace_back(guarded, i);
+        }
+        catch (...)
+        {
+            for (auto &w : workers)
+                w.join();
+            throw;
+        }
+        for (auto &w : workers)
+            w.join();
+        for (auto &e : errors)
+            if (e)
+                std::rethrow_exception(e);
+    }
+}
+
+// sorts `data` by `comp` on up to `threads` threads; T only needs to be move-constructible and
+// move-assignable. If comp throws, the first exception is rethrown once every thread has
+// stopped, and `data` is left valid but in unspecified order (some elements may be moved-from)
+template <typename T, std::size_t Extent, typename Compare = std::less<>>
+void parallel_merge_sort(std::span<T, Extent> data, Compare comp = {},
+                         unsigned threads = std::thread::hardware_concurrency())
+{
+    const std::size_t n = data.size();
+    threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(n / 4096 + 1)));
+    if (threads == 1)
+    {
+        std::sort(data.begin(), data.end(), comp);
+        return;
+    }
+
+    // phase 1: sort equal-sized runs concurrently
+    auto run_bounds = [&](std::size_t t)
+    { return n * t / threads; };
+    parallel_sort_detail::run_workers(threads, [&](unsigned t)
+                                      { std::sort(data.begin() + run_bounds(t),
+                                                  data.begin() + run_bounds(t + 1), comp); });
+
+    // phase 2: move the runs aside and merge them back into `data`; output part p is
+    // positions [n * p / threads, n * (p + 1) / threads), and takes from every run the slice
+    // between the co-ranks of its two ends
+    std::vector<T> buffer;
+    buffer.reserve(n);
+    std::move(data.begin(), data.end(), std::back_inserter(buffer));
+    std::vector<std::span<T>> runs;
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        std::size_t first = run_bounds(t);
+        runs.push_back(std::span<T>(buffer).subspan(first, run_bounds(t + 1) - first));
+    }
+    std::vector<std::vector<std::size_t>> cut(threads + 1);
+    cut[0].assign(threads, 0);
+    for (unsigned p = 1; p < threads; ++p)
+        cut[p] = parallel_sort_detail::co_ranks(runs, run_bounds(p), comp);
+    cut[threads].resize(threads);
+    for (unsigned r = 0; r < threads; ++r)
+        cut[threads][r] = runs[r].size();
+
+    parallel_sort_detail::run_workers(threads, [&](unsigned p)
+                                      {
+        std::vector<std::span<T>> slices;
+        for (unsigned r = 0; r < threads; ++r)
+            slices.push_back(runs[r].subspan(cut[p][r], cut[p + 1][r] - cut[p][r]));
+        parallel_sort_detail::multiway_merge(std::move(slices), data.data() + run_bounds(p),
+                                             comp); });
+}
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * Locale-independent, non-throwing integer parsing over std::string_view. Requires C++20.
+ *
+ * parse_int<T>() validates and converts eight digits at a time with SWAR (SIMD-within-a-
+ * register) arithmetic on one 64-bit load, and hands anything it cannot do that way (e.g.
+ * more than 19 digits) to std::from_chars. The `_int` literal in `parse_int_literals` does
+ * the same parsing at compile time, so malformed literals fail to compile.
+ */
+
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#ifndef __PARSE_INT_HPP__
+#define __PARSE_INT_HPP__
+
+namespace parse_int_detail
+{
+    // true if all eight bytes of a little-endian chunk are ASCII digits
+    inline bool is_eight_digits(uint64_t chunk)
+    {
+        return (((chunk & 0xF0F0F0F0F0F0F0F0) |
+                 (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+                0x3333333333333333);
+    }
+
+    // converts eight ASCII digits (first digit in the lowest byte) with three multiplies
+    inline uint32_t eight_digits_value(uint64_t chunk)
+    {
+        constexpr uint64_t mask = 0x000000FF000000FF;
+        constexpr uint64_t mul1 = 100 + (1000000ULL << 32);
+        constexpr uint64_t mul2 = 1 + (10000ULL << 32);
+        chunk -= 0x3030303030303030;
+        chunk = (chunk * 10) + (chunk >> 8);
+        return static_cast<uint32_t>(
+            (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32);
+    }
+
+    constexpr bool is_digit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    constexpr uint64_t pow10[8] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
+
+    // digits of a uint64_t that can never overflow it
+    constexpr std::size_t safe_digits = std::numeric_limits<uint64_t>::digits10;
+}
+
+// parses the whole of `sv` as a base-10 integer; empty input, stray characters, and values
+// out of range of T yield std::nullopt
+template <typename T = int>
+std::optional<T> parse_int(std::string_view sv)
+{
+    static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "integral T required");
+    using namespace parse_int_detail;
+    using U = std::make_unsigned_t<T>;
+    const char *p = sv.data();
+    const char *end = p + sv.size();
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>)
+    {
+        if (p != end && *p == '-')
+        {
+            negative = true;
+            ++p;
+        }
+    }
+    if (p == end || end - p > static_cast<std::ptrdiff_t>(safe_digits) ||
+        std::endian::native != std::endian::little)
+    {
+        // long inputs (possibly with leading zeros) and big-endian targets take the
+        // plain std::from_chars path
+        T value{};
+        auto [ptr, ec] = std::from_chars(sv.data(), sv.data() + sv.size(), value);
+        if (ec != std::errc() || ptr != sv.data() + sv.size())
+            return std::nullopt;
+        return value;
+    }
+    uint64_t acc = 0;
+    while (end - p >= 8)
+    {
+        uint64_t chunk;
+        std::memcpy(&chunk, p, 8);
+        if (!is_eight_digits(chunk))
+            return std::nullopt;
+        acc = acc * 100000000 + eight_digits_value(chunk);
+        p += 8;
+    }
+    if (p != end)
+    {
+        // the remaining 1..7 digits become the tail of one more eight-digit chunk padded
+        // with leading '0's, loaded either by overlapping the bytes already consumed or,
+        // for short inputs, through a small stack copy
+        const std::size_t rem = end - p;
+        const uint64_t pad = ~0ULL >> (8 * rem);
+        uint64_t chunk;
+        if (sv.size() >= 8)
+            std::memcpy(&chunk, end - 8, 8);
+        else
+        {
+            char buf[8] = {};
+            std::memcpy(buf + 8 - rem, p, rem);
+            std::memcpy(&chunk, buf, 8);
+        }
+        chunk = (chunk & ~pad) | (0x3030303030303030 & pad);
+        if (!is_eight_digits(chunk))
+            return std::nullopt;
+        acc = acc * pow10[rem] + eight_digits_value(chunk);
+    }
+    // at most 19 digits were consumed, so acc holds the exact magnitude
+    constexpr uint64_t max_pos = static_cast<U>(std::numeric_limits<T>::max());
+    if (negative)
+    {
+        if (acc > max_pos + 1)
+            return std::nullopt;
+        return static_cast<T>(static_cast<U>(0) - static_cast<U>(acc));
+    }
+    if (acc > max_pos)
+        return std::nullopt;
+    return static_cast<T>(acc);
+}
+
+namespace parse_int_literals
+{
+    // "123"_int is folded into the constant 123 by the compiler; "12a"_int or an out-of-range
+    // value is a compile error because the throw cannot be evaluated in a constant expression
+    consteval int operator"" _int(const char *str, std::size_t len)
+    {
+        if (len == 0)
+            throw std::invalid_argument("empty integer literal");
+        bool negative = str[0] == '-';
+        std::size_t i = negative ? 1 : 0;
+        if (i == len)
+            throw std::invalid_argument("empty integer literal");
+        long long acc = 0;
+        for (; i < len; ++i)
+        {
+            if (!parse_int_detail::is_digit(str[i]))
+                throw std::invalid_argument("non-digit in integer literal");
+            acc = acc * 10 + (str[i] - '0');
+            if (acc > static_cast<long long>(std::numeric_limits<int>::max()) + 1)
+                throw std::out_of_range("integer literal out of range");
+        }
+        if (negative)
+            acc = -acc;
+        if (acc > std::numeric_limits<int>::max())
+            throw std::out_of_range("integer literal out of range");
+        return static_cast<int>(acc);
+    }
+}
+
+#endif
@@ -0,0 +1,554 @@
+/**
+ * Safe memory reclamation for lock-free data structures. Requires C++17.
+ *
+ * A lock-free structure cannot delete a node as soon as it unlinks it, because another thread
+ * may still be reading it. Both domains below defer the delete until no reader can hold it:
+ *
+ * - ebr_domain: epoch-based reclamation. Readers pin the current global epoch for the length
+ *   of an operation; a retired node is freed once the epoch has advanced twice past the one
+ *   it was retired in. Reads cost two stores to a thread-private cache line, but a stalled
+ *   reader blocks all reclamation.
+ * - hazard_domain: hazard pointers. Readers publish each pointer they are about to
+ *   dereference; a retired node is freed once no published pointer matches it. Reads cost a
+ *   store and a re-check per pointer, but reclamation is bounded even with stalled readers.
+ *
+ * Both expose the same guard interface (pin(), protect(), reset(), retire()), so the
+ * lock_free_stack and lock_free_list below work with either. Each thread registers itself on
+ * first use and gives its record back when it exits; retired nodes left over are freed by
+ * the next owner of the record or by the domain destructor. Destroying a domain requires that
+ * no thread is inside an operation on it.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifndef __RECLAMATION_HPP__
+#define __RECLAMATION_HPP__
+
+namespace reclamation_detail
+{
+    constexpr std::size_t cache_line = 64;
+    constexpr std::size_t max_threads = 128;
+    // hazard slots per guard; a sorted-list traversal needs three (prev, cur, next)
+    constexpr std::size_t guard_slots = 3;
+
+    struct retired
+    {
+        void *ptr;
+        void (*deleter)(void *);
+        uint64_t epoch;
+    };
+
+    template <typename T>
+    void delete_as(void *p)
+    {
+        delete static_cast<T *>(p);
+    }
+
+    inline std::size_t free_all(std::vector<retired> &list)
+    {
+        std::size_t n = list.size();
+        for (const retired &r : list)
+            r.deleter(r.ptr);
+        list.clear();
+        return n;
+    }
+
+    // per-thread records of one domain, shared by the domain and every thread registered
+    // with it, so a thread exiting after the domain is gone still has a record to give back
+    template <typename Record>
+    struct registry
+    {
+        Record records[max_threads];
+    };
+
+    template <typename Record>
+    class thread_records
+    {
+        struct entry
+        {
+            registry<Record> *key;
+            Record *rec;
+            std::shared_ptr<registry<Record>> keep;
+        };
+        std::vector<entry> entries;
+
+    public:
+        ~thread_records()
+        {
+            for (entry &e : entries)
+            {
+                e.rec->release();
+                e.rec->in_use.store(false, std::memory_order_release);
+            }
+        }
+
+        Record &get(const std::shared_ptr<registry<Record>> &reg)
+        {
+            for (entry &e : entries)
+                if (e.key == reg.get())
+                    return *e.rec;
+            // forget records of domains that no longer exist before registering a new one
+            entries.erase(std::remove_if(entries.begin(), entries.end(), [](const entry &e)
+                                         { return e.keep.use_count() == 1; }),
+                          entries.end());
+            for (Record &r : reg->records)
+            {
+                bool expected = false;
+                if (!r.in_use.load(std::memory_order_relaxed) &&
+                    r.in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                {
+                    entries.push_back(entry{reg.get(), &r, reg});
+                    return r;
+                }
+            }
+            throw std::runtime_error("too many threads registered with a reclamation domain");
+        }
+    };
+
+    template <typename Record>
+    Record &local_record(const std::shared_ptr<registry<Record>> &reg)
+    {
+        thread_local thread_records<Record> records;
+        return records.get(reg);
+    }
+}
+
+/////////////////////////////
+// Epoch-based reclamation //
+/////////////////////////////
+
+class ebr_domain
+{
+    struct alignas(reclamation_detail::cache_line) record
+    {
+        std::atomic<bool> in_use{false};
+        std::atomic<uint64_t> state{0}; // (epoch << 1) | pinned
+        unsigned nesting = 0;
+        std::vector<reclamation_detail::retired> retired;
+        std::size_t retires_since_collect = 0;
+
+        void release() {}
+    };
+    using registry = reclamation_detail::registry<record>;
+
+    static constexpr std::size_t collect_every = 64;
+
+    alignas(reclamation_detail::cache_line) std::atomic<uint64_t> global_epoch{2};
+    std::shared_ptr<registry> reg = std::make_shared<registry>();
+
+    record &local() { return reclamation_detail::local_record(reg); }
+
+    // the epoch may move on only once every pinned thread has seen the current one
+    bool try_advance()
+    {
+        uint64_t e = global_epoch.load();
+        for (record &r : reg->records)
+        {
+            uint64_t s = r.state.load();
+            if ((s & 1) && (s >> 1) != e)
+                return false;
+        }
+        return global_epoch.compare_exchange_strong(e, e + 1);
+    }
+
+    std::size_t collect(record &r)
+    {
+        r.retires_since_collect = 0;
+        try_advance();
+        const uint64_t e = global_epoch.load(std::memory_order_acquire);
+        // nodes were appended in epoch order, so the safe ones form a prefix
+        auto safe_end = r.retired.begin();
+        while (safe_end != r.retired.end() && safe_end->epoch + 2 <= e)
+            ++safe_end;
+        for (auto it = r.retired.begin(); it != safe_end; ++it)
+            it->deleter(it->ptr);
+        std::size_t n = safe_end - r.retired.begin();
+        r.retired.erase(r.retired.begin(), safe_end);
+        return n;
+    }
+
+public:
+    ebr_domain() = default;
+    ebr_domain(const ebr_domain &) = delete;
+    ebr_domain &operator=(const ebr_domain &) = delete;
+    ~ebr_domain()
+    {
+        for (record &r : reg->records)
+            reclamation_detail::free_all(r.retired);
+    }
+
+    // keeps the calling thread pinned to an epoch while alive; guards nest
+    class guard
+    {
+        record *r;
+
+    public:
+        explicit guard(record &rec, uint64_t epoch) : r(&rec)
+        {
+            if (r->nesting++ == 0)
+            {
+                r->state.store((epoch << 1) | 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+        guard(guard &&o) : r(std::exchange(o.r, nullptr)) {}
+        guard(const guard &) = delete;
+        guard &operator=(const guard &) = delete;
+        ~guard()
+        {
+            if (r && --r->nesting == 0)
+                r->state.store(0, std::memory_order_release);
+        }
+
+        // the epoch already keeps everything reachable alive, so these are plain loads
+        template <typename T>
+        T *protect(std::size_t, const std::atomic<T *> &src) const
+        {
+            return src.load(std::memory_order_acquire);
+        }
+        template <typename T>
+        void reset(std::size_t, T *) const {}
+    };
+
+    guard pin() { return guard(local(), global_epoch.load(std::memory_order_relaxed)); }
+
+    // `p` must already be unreachable for threads that pin from now on
+    template <typename T>
+    void retire(T *p)
+    {
+        record &r = local();
+        r.retired.push_back({p, &reclamation_detail::delete_as<T>, global_epoch.load()});
+        if (++r.retires_since_collect >= collect_every)
+            collect(r);
+    }
+
+    // tries to advance the epoch and frees what the calling thread retired that is now safe;
+    // returns the number of nodes freed
+    std::size_t reclaim() { return collect(local()); }
+
+    // nodes the calling thread retired that are not freed yet
+    std::size_t pending() { return local().retired.size(); }
+};
+
+/////////////////////
+// Hazard pointers //
+/////////////////////
+
+class hazard_domain
+{
+    struct alignas(reclamation_detail::cache_line) record
+    {
+        std::atomic<bool> in_use{false};
+        std::atomic<void *> hazards[reclamation_detail::guard_slots] = {};
+        bool guarded = false;
+        std::vector<reclamation_detail::retired> retired;
+
+        void release()
+        {
+            for (auto &h : hazards)
+                h.store(nullptr, std::memory_order_release);
+        }
+    };
+    using registry = reclamation_detail::registry<record>;
+
+    static constexpr std::size_t scan_threshold = 64;
+
+    std::shared_ptr<registry> reg = std::make_shared<registry>();
+
+    record &local() { return reclamation_detail::local_record(reg); }
+
+    std::size_t scan(record &r)
+    {
+        std::vector<void *> protected_ptrs;
+        for (record &other : reg->records)
+            for (auto &h : other.hazards)
+                if (void *p = h.load())
+                    protected_ptrs.push_back(p);
+        std::sort(protected_ptrs.begin(), protected_ptrs.end());
+        std::size_t freed = 0;
+        auto keep = std::remove_if(r.retired.begin(), r.retired.end(),
+                                   [&](const reclamation_detail::retired &x)
+                                   {
+                                       if (std::binary_search(protected_ptrs.begin(),
+                                                              protected_ptrs.end(), x.ptr))
+                                           return false;
+                                       x.deleter(x.ptr);
+                                       ++freed;
+                                       return true;
+                                   });
+        r.retired.erase(keep, r.retired.end());
+        return freed;
+    }
+
+    // lists mark pointers in their low bit; hazards always hold the plain address
+    template <typename T>
+    static void *strip(T *p)
+    {
+        return reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(p) & ~uintptr_t(1));
+    }
+
+public:
+    hazard_domain() = default;
+    hazard_domain(const hazard_domain &) = delete;
+    hazard_domain &operator=(const hazard_domain &) = delete;
+    ~hazard_domain()
+    {
+        for (record &r : reg->records)
+            reclamation_detail::free_all(r.retired);
+    }
+
+    // owns the calling thread's hazard slots while alive; one guard per thread at a time
+    class guard
+    {
+        record *r;
+
+    public:
+        explicit guard(record &rec) : r(&rec)
+        {
+            if (r->guarded)
+                throw std::logic_error("hazard_domain guards do not nest");
+            r->guarded = true;
+        }
+        guard(guard &&o) : r(std::exchange(o.r, nullptr)) {}
+        guard(const guard &) = delete;
+        guard &operator=(const guard &) = delete;
+        ~guard()
+        {
+            if (r)
+            {
+                r->release();
+                r->guarded = false;
+            }
+        }
+
+        // publishes the value of `src` in slot i, re-reading until the published value is
+        // still current -- from then on it cannot be freed until the slot changes
+        template <typename T>
+        T *protect(std::size_t i, const std::atomic<T *> &src)
+        {
+            T *p = src.load(std::memory_order_acquire);
+            for (;;)
+            {
+                r->hazards[i].store(strip(p));
+                T *again = src.load();
+                if (again == p)
+                    return p;
+                p = again;
+            }
+        }
+
+        // moves protection of a pointer that is already protected in another slot
+        template <typename T>
+        void reset(std::size_t i, T *p)
+        {
+            r->hazards[i].store(strip(p));
+        }
+    };
+
+    guard pin() { return guard(local()); }
+
+    template <typename T>
+    void retire(T *p)
+    {
+        record &r = local();
+        r.retired.push_back({p, &reclamation_detail::delete_as<T>, 0});
+        if (r.retired.size() >= scan_threshold)
+            scan(r);
+    }
+
+    std::size_t reclaim() { return scan(local()); }
+    std::size_t pending() { return local().retired.size(); }
+};
+
+/////////////////////
+// Lock-free stack //
+/////////////////////
+
+// Treiber stack; the guard keeps the popped head alive while its `next` is read, which also
+// rules out the ABA problem of a node being freed and reallocated under a pending CAS
+template <typename T, typename Domain>
+class lock_free_stack
+{
+    struct node
+    {
+        T value;
+        node *next;
+    };
+
+    Domain &domain;
+    std::atomic<node *> head{nullptr};
+
+public:
+    explicit lock_free_stack(Domain &domain) : domain(domain) {}
+    lock_free_stack(const lock_free_stack &) = delete;
+    lock_free_stack &operator=(const lock_free_stack &) = delete;
+    ~lock_free_stack()
+    {
+        for (node *n = head.load(); n != nullptr;)
+            delete std::exchange(n, n->next);
+    }
+
+    void push(T value)
+    {
+        node *n = new node{std::move(value), head.load(std::memory_order_relaxed)};
+        while (!head.compare_exchange_weak(n->next, n, std::memory_order_release,
+                                           std::memory_order_relaxed))
+            ;
+    }
+
+    std::optional<T> pop()
+    {
+        auto g = domain.pin();
+        for (;;)
+        {
+            node *h = g.protect(0, head);
+            if (h == nullptr)
+                return std::nullopt;
+            if (head.compare_exchange_strong(h, h->next, std::memory_order_acquire))
+            {
+                std::optional<T> value(std::move(h->value));
+                domain.retire(h);
+                return value;
+            }
+        }
+    }
+
+    bool empty() const { return head.load() == nullptr; }
+};
+
+////////////////////
+// Lock-free list //
+////////////////////
+
+// sorted set of keys (Harris-Michael list): remove() first marks the low bit of the node's
+// `next`, which stops inserts after it, and then unlinks it; any traversal that meets a
+// marked node helps unlink it, and whoever unlinks a node retires it
+template <typename Key, typename Domain>
+class lock_free_list
+{
+    struct node
+    {
+        Key key;
+        std::atomic<node *> next;
+    };
+
+    static bool is_marked(node *p) { return reinterpret_cast<uintptr_t>(p) & 1; }
+    static node *marked(node *p)
+    {
+        return reinterpret_cast<node *>(reinterpret_cast<uintptr_t>(p) | 1);
+    }
+    static node *unmarked(node *p)
+    {
+        return reinterpret_cast<node *>(reinterpret_cast<uintptr_t>(p) & ~uintptr_t(1));
+    }
+
+    Domain &domain;
+    std::atomic<node *> head{nullptr};
+
+    // slots: 0 = next, 1 = cur, 2 = prev node (owner of *prev)
+    struct position
+    {
+        std::atomic<node *> *prev;
+        node *cur;
+        node *next;
+    };
+
+    // finds the first unmarked node with key >= `key`, unlinking marked nodes on the way
+    template <typename Guard>
+    bool find(Guard &g, const Key &key, position &pos)
+    {
+    retry:
+        pos.prev = &head;
+        pos.cur = g.protect(1, *pos.prev);
+        for (;;)
+        {
+            if (pos.cur == nullptr)
+                return false;
+            pos.next = g.protect(0, pos.cur->next);
+            if (pos.prev->load() != pos.cur)
+                goto retry;
+            if (!is_marked(pos.next))
+            {
+                if (!(pos.cur->key < key))
+                    return !(key < pos.cur->key);
+                pos.prev = &pos.cur->next;
+                g.reset(2, pos.cur);
+            }
+            else
+            {
+                node *expected = pos.cur;
+                if (!pos.prev->compare_exchange_strong(expected, unmarked(pos.next)))
+                    goto retry;
+                domain.retire(pos.cur);
+            }
+            pos.cur = unmarked(pos.next);
+            g.reset(1, pos.cur);
+        }
+    }
+
+public:
+    explicit lock_free_list(Domain &domain) : domain(domain) {}
+    lock_free_list(const lock_free_list &) = delete;
+    lock_free_list &operator=(const lock_free_list &) = delete;
+    ~lock_free_list()
+    {
+        for (node *n = head.load(); n != nullptr;)
+            delete std::exchange(n, unmarked(n->next.load()));
+    }
+
+    bool insert(const Key &key)
+    {
+        auto g = domain.pin();
+        node *n = new node{key, {nullptr}};
+        position pos;
+        for (;;)
+        {
+            if (find(g, key, pos))
+            {
+                delete n;
+                return false;
+            }
+            n->next.store(pos.cur, std::memory_order_relaxed);
+            node *expected = pos.cur;
+            if (pos.prev->compare_exchange_strong(expected, n))
+                return true;
+        }
+    }
+
+    bool remove(const Key &key)
+    {
+        auto g = domain.pin();
+        position pos;
+        for (;;)
+        {
+            if (!find(g, key, pos))
+                return false;
+            node *next = pos.next;
+            if (!pos.cur->next.compare_exchange_strong(next, marked(next)))
+                continue;
+            node *expected = pos.cur;
+            if (pos.prev->compare_exchange_strong(expected, next))
+                domain.retire(pos.cur);
+            else
+                find(g, key, pos); // let a traversal unlink it
+            return true;
+        }
+    }
+
+    bool contains(const Key &key)
+    {
+        auto g = domain.pin();
+        position pos;
+        return find(g, key, pos);
+    }
+};
+
+#endif
@@ -0,0 +1,207 @@
+/**
+ * Bounded lock-free queues for handing data across threads. Requires C++17.
+ *
+ * - spsc_ring<T>: one producer thread, one consumer thread. Each side keeps a private copy
+ *   of the other side's index and only re-reads the shared atomic when that copy says the
+ *   ring looks full (or empty), so in steady state the two cores barely share cache lines
+ * - mpmc_queue<T>: any number of producers and consumers; Dmitry Vyukov's bounded queue,
+ *   where a per-cell sequence number tells whether the cell is ready to be written or read
+ *
+ * Both round the capacity up to a power of two and support batch push/pop, which claim
+ * several slots with one atomic update.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#ifndef __RING_BUFFER_HPP__
+#define __RING_BUFFER_HPP__
+
+namespace ring_buffer_detail
+{
+    // fixed instead of std::hardware_destructive_interference_size, whose value may change
+    // between compiler versions (GCC warns about using it in headers for that reason)
+    constexpr std::size_t cache_line = 64;
+
+    inline std::size_t round_up_pow2(std::size_t n)
+    {
+        std::size_t p = 1;
+        while (p < n)
+            p <<= 1;
+        return p;
+    }
+}
+
+/////////////////////////////////////
+// Single-producer single-consumer //
+/////////////////////////////////////
+
+template <typename T>
+class spsc_ring
+{
+    static constexpr std::size_t line = ring_buffer_detail::cache_line;
+
+    // consumer-owned line
+    alignas(line) std::atomic<std::size_t> head{0};
+    std::size_t cached_tail = 0;
+    // producer-owned line
+    alignas(line) std::atomic<std::size_t> tail{0};
+    std::size_t cached_head = 0;
+    // read-only after construction
+    alignas(line) const std::size_t mask;
+    const std::unique_ptr<T[]> slots;
+
+public:
+    explicit spsc_ring(std::size_t capacity)
+        : mask(ring_buffer_detail::round_up_pow2(capacity) - 1), slots(new T[mask + 1]) {}
+
+    std::size_t capacity() const { return mask + 1; }
+
+    // producer side: pushes up to n items, returns how many were pushed
+    template <typename It>
+    std::size_t push_batch(It items, std::size_t n)
+    {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t + n - cached_head > capacity())
+            cached_head = head.load(std::memory_order_acquire);
+        const std::size_t room = capacity() - (t - cached_head);
+        n = n < room ? n : room;
+        for (std::size_t i = 0; i < n; ++i, ++items)
+            slots[(t + i) & mask] = *items;
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    bool try_push(T item)
+    {
+        auto it = std::make_move_iterator(&item);
+        return push_batch(it, 1) == 1;
+    }
+
+    // consumer side: pops up to max items into `out`, returns how many were popped
+    template <typename It>
+    std::size_t pop_batch(It out, std::size_t max)
+    {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        if (cached_tail - h < max)
+            cached_tail = tail.load(std::memory_order_acquire);
+        const std::size_t avail = cached_tail - h;
+        const std::size_t n = max < avail ? max : avail;
+        for (std::size_t i = 0; i < n; ++i, ++out)
+            *out = std::move(slots[(h + i) & mask]);
+        head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    bool try_pop(T &item)
+    {
+        return pop_batch(&item, 1) == 1;
+    }
+};
+
+///////////////////////////////////
+// Multi-producer multi-consumer //
+///////////////////////////////////
+
+template <typename T>
+class mpmc_queue
+{
+    static constexpr std::size_t line = ring_buffer_detail::cache_line;
+
+    // cell i is free for position p when seq == p, and holds the item of p when seq == p + 1
+    struct cell
+    {
+        std::atomic<std::size_t> seq;
+        T data;
+    };
+
+    alignas(line) std::atomic<std::size_t> enqueue_pos{0};
+    alignas(line) std::atomic<std::size_t> dequeue_pos{0};
+    alignas(line) const std::size_t mask;
+    const std::unique_ptr<cell[]> cells;
+
+    // claims up to n consecutive positions whose cells are in state `pos + ready_offset`;
+    // returns the first claimed position and stores the count in n
+    std::size_t claim(std::atomic<std::size_t> &cursor, std::size_t ready_offset, std::size_t &n)
+    {
+        std::size_t pos = cursor.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            std::size_t k = 0;
+            while (k < n && k <= mask &&
+                   cells[(pos + k) & mask].seq.load(std::memory_order_acquire) ==
+                       pos + k + ready_offset)
+                ++k;
+            if (k == 0)
+            {
+                // either truly full / empty, or another thread moved the cursor already
+                std::size_t now = cursor.load(std::memory_order_relaxed);
+                if (now == pos)
+                {
+                    n = 0;
+                    return pos;
+                }
+                pos = now;
+                continue;
+            }
+            if (cursor.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed))
+            {
+                n = k;
+                return pos;
+            }
+        }
+    }
+
+public:
+    explicit mpmc_queue(std::size_t capacity)
+        : mask(ring_buffer_detail::round_up_pow2(capacity < 2 ? 2 : capacity) - 1),
+          cells(new cell[mask + 1])
+    {
+        for (std::size_t i = 0; i <= mask; ++i)
+            cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    std::size_t capacity() const { return mask + 1; }
+
+    template <typename It>
+    std::size_t push_batch(It items, std::size_t n)
+    {
+        const std::size_t pos = claim(enqueue_pos, 0, n);
+        for (std::size_t i = 0; i < n; ++i, ++items)
+        {
+            cell &c = cells[(pos + i) & mask];
+            c.data = *items;
+            c.seq.store(pos + i + 1, std::memory_order_release);
+        }
+        return n;
+    }
+
+    bool try_push(T item)
+    {
+        auto it = std::make_move_iterator(&item);
+        return push_batch(it, 1) == 1;
+    }
+
+    template <typename It>
+    std::size_t pop_batch(It out, std::size_t max)
+    {
+        const std::size_t pos = claim(dequeue_pos, 1, max);
+        for (std::size_t i = 0; i < max; ++i, ++out)
+        {
+            cell &c = cells[(pos + i) & mask];
+            *out = std::move(c.data);
+            c.seq.store(pos + i + mask + 1, std::memory_order_release);
+        }
+        return max;
+    }
+
+    bool try_pop(T &item)
+    {
+        return pop_batch(&item, 1) == 1;
+    }
+};
+
+#endif
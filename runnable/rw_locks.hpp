@@ -0,0 +1,218 @@
+/**
+ * Locks for read-mostly shared data. Requires C++17.
+ *
+ * - seqlock<T>: a writer bumps a sequence counter around each update and readers simply copy
+ *   the value, retrying if the counter changed meanwhile. Readers never write shared memory,
+ *   so they do not bounce a cache line between cores; meant for small trivially copyable T.
+ * - distributed_rw_lock: a reader-writer lock whose reader count is split into per-core slots
+ *   on separate cache lines. A reader only touches its own slot; a writer sets a flag and
+ *   waits for every slot to drain. Meets the SharedMutex requirements, so it works with
+ *   std::shared_lock / std::unique_lock. Writers are preferred over new readers.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+#ifndef __RW_LOCKS_HPP__
+#define __RW_LOCKS_HPP__
+
+namespace rw_locks_detail
+{
+    constexpr std::size_t cache_line = 64;
+
+    inline void pause()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+
+    // spins briefly, then yields so an oversubscribed machine still makes progress
+    struct backoff
+    {
+        int spins = 0;
+        void operator()()
+        {
+            if (++spins < 64)
+                pause();
+            else
+                std::this_thread::yield();
+        }
+    };
+}
+
+/////////////
+// Seqlock //
+/////////////
+
+template <typename T>
+class seqlock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "seqlock needs a trivially copyable T");
+
+    using word = unsigned long;
+    static constexpr std::size_t num_words = (sizeof(T) + sizeof(word) - 1) / sizeof(word);
+
+    alignas(rw_locks_detail::cache_line) std::atomic<unsigned> seq{0};
+    std::atomic<bool> writing{false};
+    // stored as relaxed atomic words, so a reader racing with a writer reads torn data (and
+    // then retries) instead of triggering a data race
+    std::atomic<word> words[num_words];
+
+    void store_words(const T &value)
+    {
+        word tmp[num_words] = {};
+        std::memcpy(tmp, &value, sizeof(T));
+        for (std::size_t i = 0; i < num_words; ++i)
+            words[i].store(tmp[i], std::memory_order_relaxed);
+    }
+
+public:
+    explicit seqlock(const T &value = T{}) { store_words(value); }
+
+    T load() const
+    {
+        word tmp[num_words];
+        rw_locks_detail::backoff wait;
+        for (;;)
+        {
+            unsigned before = seq.load(std::memory_order_acquire);
+            if (before & 1)
+            {
+                wait();
+                continue;
+            }
+            for (std::size_t i = 0; i < num_words; ++i)
+                tmp[i] = words[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) == before)
+                break;
+        }
+        T value;
+        std::memcpy(&value, tmp, sizeof(T));
+        return value;
+    }
+
+    // writers are serialized among themselves; `f` gets a copy of the current value to modify
+    template <typename F>
+    void update(F &&f)
+    {
+        rw_locks_detail::backoff wait;
+        while (writing.exchange(true, std::memory_order_acquire))
+            wait();
+        T value = load();
+        f(value);
+        unsigned s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        store_words(value);
+        seq.store(s + 2, std::memory_order_release);
+        writing.store(false, std::memory_order_release);
+    }
+
+    void store(const T &value)
+    {
+        update([&](T &v)
+               { v = value; });
+    }
+};
+
+/////////////////////////////////
+// Per-core reader-writer lock //
+/////////////////////////////////
+
+class distributed_rw_lock
+{
+    struct alignas(rw_locks_detail::cache_line) slot
+    {
+        std::atomic<int> readers{0};
+    };
+
+    alignas(rw_locks_detail::cache_line) std::atomic<bool> writer{false};
+    const std::size_t mask;
+    const std::unique_ptr<slot[]> slots;
+
+    // threads are numbered once, in order of first use, so consecutive threads get distinct
+    // slots (a hash of std::thread::id gives no such guarantee)
+    static std::size_t thread_index()
+    {
+        static std::atomic<std::size_t> next{0};
+        thread_local std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    static std::size_t slot_count(std::size_t wanted)
+    {
+        std::size_t n = 1;
+        while (n < wanted)
+            n <<= 1;
+        return n;
+    }
+
+    std::atomic<int> &my_slot() { return slots[thread_index() & mask].readers; }
+
+public:
+    explicit distributed_rw_lock(std::size_t slots_hint = std::thread::hardware_concurrency())
+        : mask(slot_count(slots_hint) - 1), slots(new slot[mask + 1]) {}
+
+    distributed_rw_lock(const distributed_rw_lock &) = delete;
+    distributed_rw_lock &operator=(const distributed_rw_lock &) = delete;
+
+    // the reader increments its slot and then checks the writer flag, while the writer sets the
+    // flag and then checks the slots; both sides use seq_cst so at least one sees the other
+    bool try_lock_shared()
+    {
+        std::atomic<int> &r = my_slot();
+        r.fetch_add(1);
+        if (!writer.load())
+            return true;
+        r.fetch_sub(1, std::memory_order_release);
+        return false;
+    }
+
+    void lock_shared()
+    {
+        rw_locks_detail::backoff wait;
+        while (!try_lock_shared())
+            while (writer.load(std::memory_order_relaxed))
+                wait();
+    }
+
+    void unlock_shared() { my_slot().fetch_sub(1, std::memory_order_release); }
+
+    bool try_lock()
+    {
+        bool expected = false;
+        if (!writer.compare_exchange_strong(expected, true))
+            return false;
+        for (std::size_t i = 0; i <= mask; ++i)
+            if (slots[i].readers.load() != 0)
+            {
+                writer.store(false, std::memory_order_release);
+                return false;
+            }
+        return true;
+    }
+
+    void lock()
+    {
+        rw_locks_detail::backoff wait;
+        bool expected = false;
+        while (!writer.compare_exchange_weak(expected, true))
+        {
+            expected = false;
+            wait();
+        }
+        for (std::size_t i = 0; i <= mask; ++i)
+            while (slots[i].readers.load() != 0)
+                wait();
+    }
+
+    void unlock() { writer.store(false, std::memory_order_release); }
+};
+
+#endif
@@ -0,0 +1,192 @@
+/**
+ * Struct-of-arrays container for tuple-like records. Requires C++17.
+ *
+ * soa_vector<Ts...> keeps every field in its own contiguous std::vector, so a scan over one
+ * field only touches that field's bytes and vectorizes like a loop over a plain array. Rows
+ * are still accessible as a whole through proxy references (std::tuple<Ts &...>), which work
+ * with structured bindings just like a std::tuple element would. push_back() and resize()
+ * leave every column at the old size if any of them throws, so the columns never disagree on
+ * the row count. bool columns are rejected: std::vector<bool> packs its bits and has no data()
+ * to hand out, so store flags as uint8_t instead.
+ */
+
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifndef __SOA_VECTOR_HPP__
+#define __SOA_VECTOR_HPP__
+
+// contiguous, non-owning view of one column
+template <typename T>
+class column_view
+{
+    T *ptr;
+    std::size_t len;
+
+public:
+    column_view(T *ptr, std::size_t len) : ptr(ptr), len(len) {}
+    T *data() const { return ptr; }
+    std::size_t size() const { return len; }
+    T *begin() const { return ptr; }
+    T *end() const { return ptr + len; }
+    T &operator[](std::size_t i) const { return ptr[i]; }
+};
+
+template <typename... Ts>
+class soa_vector
+{
+    static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one column");
+    static_assert((!std::is_same_v<Ts, bool> && ...),
+                  "bool columns would be std::vector<bool>; use uint8_t instead");
+
+    std::tuple<std::vector<Ts>...> columns;
+
+    template <std::size_t... Is>
+    std::tuple<Ts &...> row(std::size_t i, std::index_sequence<Is...>)
+    {
+        return std::tuple<Ts &...>(std::get<Is>(columns)[i]...);
+    }
+    template <std::size_t... Is>
+    std::tuple<const Ts &...> row(std::size_t i, std::index_sequence<Is...>) const
+    {
+        return std::tuple<const Ts &...>(std::get<Is>(columns)[i]...);
+    }
+
+    template <typename F>
+    void for_each_column(F &&f)
+    {
+        std::apply([&](auto &...cols)
+                   { (f(cols), ...); },
+                   columns);
+    }
+
+    // drops the rows past `n` that some columns gained before an exception
+    void truncate_to(std::size_t n) noexcept
+    {
+        for_each_column([n](auto &col)
+                        { while (col.size() > n) col.pop_back(); });
+    }
+
+public:
+    using value_type = std::tuple<Ts...>;
+    using reference = std::tuple<Ts &...>;
+    using const_reference = std::tuple<const Ts &...>;
+
+    // yields proxy references; models an input iterator, since the reference type is not a
+    // real reference (so e.g. std::sort cannot permute rows through it)
+    template <bool Const>
+    class basic_iterator
+    {
+        using Owner = std::conditional_t<Const, const soa_vector, soa_vector>;
+        Owner *owner;
+        std::size_t i;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::tuple<Ts...>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, std::tuple<const Ts &...>, std::tuple<Ts &...>>;
+        using pointer = void;
+
+        basic_iterator(Owner *owner, std::size_t i) : owner(owner), i(i) {}
+        reference operator*() const { return (*owner)[i]; }
+        basic_iterator &operator++()
+        {
+            ++i;
+            return *this;
+        }
+        basic_iterator operator++(int)
+        {
+            basic_iterator tmp = *this;
+            ++i;
+            return tmp;
+        }
+        bool operator==(const basic_iterator &o) const { return i == o.i; }
+        bool operator!=(const basic_iterator &o) const { return i != o.i; }
+    };
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    std::size_t size() const { return std::get<0>(columns).size(); }
+    bool empty() const { return size() == 0; }
+
+    void reserve(std::size_t n)
+    {
+        for_each_column([n](auto &col)
+                        { col.reserve(n); });
+    }
+    void resize(std::size_t n)
+    {
+        const std::size_t old = size();
+        try
+        {
+            for_each_column([n](auto &col)
+                            { col.resize(n); });
+        }
+        catch (...)
+        {
+            truncate_to(old);
+            throw;
+        }
+    }
+    void clear()
+    {
+        for_each_column([](auto &col)
+                        { col.clear(); });
+    }
+    void pop_back()
+    {
+        for_each_column([](auto &col)
+                        { col.pop_back(); });
+    }
+
+    template <typename... Args, typename = std::enable_if_t<sizeof...(Args) == sizeof...(Ts)>>
+    void push_back(Args &&...fields)
+    {
+        push_back_impl(std::index_sequence_for<Ts...>{}, std::forward<Args>(fields)...);
+    }
+    void push_back(const value_type &t)
+    {
+        std::apply([this](const Ts &...fields)
+                   { push_back(fields...); },
+                   t);
+    }
+
+    reference operator[](std::size_t i) { return row(i, std::index_sequence_for<Ts...>{}); }
+    const_reference operator[](std::size_t i) const
+    {
+        return row(i, std::index_sequence_for<Ts...>{});
+    }
+
+    template <std::size_t I>
+    auto column() { return column_view(std::get<I>(columns).data(), size()); }
+    template <std::size_t I>
+    auto column() const { return column_view(std::get<I>(columns).data(), size()); }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+private:
+    template <std::size_t... Is, typename... Args>
+    void push_back_impl(std::index_sequence<Is...>, Args &&...fields)
+    {
+        const std::size_t old = size();
+        try
+        {
+            (std::get<Is>(columns).push_back(std::forward<Args>(fields)), ...);
+        }
+        catch (...)
+        {
+            truncate_to(old);
+            throw;
+        }
+    }
+};
+
+#endif
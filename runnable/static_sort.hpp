@@ -0,0 +1,102 @@
+/**
+ * Sorting networks for small fixed-size std::array. Requires C++17.
+ *
+ * The comparator network for a given N is Batcher's odd-even merge sort, generated at compile
+ * time and then fully unrolled into a straight sequence of compare-exchanges. Each compare-
+ * exchange is a pair of selects, which compilers emit as cmov / min / max instructions, so
+ * sorting arithmetic values involves no data-dependent branches at all. Other types (strings,
+ * handles, move-only types) are swapped only when out of order, since copying both elements
+ * on every comparator would cost far more than the branch. For N <= 4 and N = 8 the network has
+ * the optimal number of comparators; for other N <= 32 it is within a few of the best known.
+ */
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#ifndef __STATIC_SORT_HPP__
+#define __STATIC_SORT_HPP__
+
+namespace static_sort_detail
+{
+    struct comparator
+    {
+        std::size_t lo;
+        std::size_t hi;
+    };
+
+    // calls emit(i, j) for every comparator of Batcher's odd-even merge sort on n elements;
+    // this formulation works for any n, not only powers of two
+    template <typename Emit>
+    constexpr void batcher_network(std::size_t n, Emit &&emit)
+    {
+        for (std::size_t p = 1; p < n; p <<= 1)
+            for (std::size_t k = p; k >= 1; k >>= 1)
+                for (std::size_t j = k % p; j + k < n; j += 2 * k)
+                    for (std::size_t i = 0; i < k && i + j + k < n; ++i)
+                        if ((i + j) / (2 * p) == (i + j + k) / (2 * p))
+                            emit(i + j, i + j + k);
+    }
+
+    template <std::size_t N>
+    constexpr std::size_t network_size()
+    {
+        std::size_t count = 0;
+        batcher_network(N, [&](std::size_t, std::size_t)
+                        { ++count; });
+        return count;
+    }
+
+    template <std::size_t N>
+    constexpr auto make_network()
+    {
+        std::array<comparator, network_size<N>()> net{};
+        std::size_t c = 0;
+        batcher_network(N, [&](std::size_t i, std::size_t j)
+                        { net[c++] = comparator{i, j}; });
+        return net;
+    }
+
+    template <std::size_t N>
+    inline constexpr auto network = make_network<N>();
+
+    template <std::size_t I, std::size_t J, typename T, std::size_t N, typename Compare>
+    constexpr void compare_exchange(std::array<T, N> &a, Compare &comp)
+    {
+        if constexpr (std::is_arithmetic_v<T>)
+        {
+            const T x = a[I];
+            const T y = a[J];
+            const bool swap = comp(y, x);
+            a[I] = swap ? y : x;
+            a[J] = swap ? x : y;
+        }
+        else if (comp(a[J], a[I]))
+        {
+            using std::swap;
+            swap(a[I], a[J]);
+        }
+    }
+
+    template <typename T, std::size_t N, typename Compare, std::size_t... Cs>
+    constexpr void apply_network(std::array<T, N> &a, Compare &comp, std::index_sequence<Cs...>)
+    {
+        (compare_exchange<network<N>[Cs].lo, network<N>[Cs].hi>(a, comp), ...);
+    }
+}
+
+// number of compare-exchanges static_sort performs on N elements
+template <std::size_t N>
+inline constexpr std::size_t static_sort_comparators = static_sort_detail::network_size<N>();
+
+// sorts `a` in place with a compile-time sorting network; not stable, meant for small N
+template <typename T, std::size_t N, typename Compare = std::less<>>
+constexpr void static_sort(std::array<T, N> &a, Compare comp = {})
+{
+    static_sort_detail::apply_network(a, comp,
+                                      std::make_index_sequence<static_sort_comparators<N>>{});
+}
+
+#endif
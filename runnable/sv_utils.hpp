@@ -0,0 +1,269 @@
+/**
+ * Non-copying std::string_view helpers for parsing large buffers. Requires C++17.
+ *
+ * Byte searches look at 64 bytes per step: four 16-byte SSE2 compares (or two 32-byte AVX2
+ * compares when built with -mavx2) are folded into one 64-bit match mask, so the loop only
+ * branches once per 64 bytes. A scalar fallback is used on targets without SSE2.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#ifndef __SV_UTILS_HPP__
+#define __SV_UTILS_HPP__
+
+namespace sv_detail
+{
+    constexpr std::size_t BLOCK = 64;
+
+    // whitespace as in std::isspace for the "C" locale: ' ', '\t', '\n', '\v', '\f', '\r'
+    constexpr bool is_ws(char c)
+    {
+        return c == ' ' || static_cast<unsigned char>(c - '\t') <= '\r' - '\t';
+    }
+
+#if defined(__AVX2__)
+    inline uint64_t eq_mask(const char *p, char c)
+    {
+        const __m256i needle = _mm256_set1_epi8(c);
+        auto half = [&](const char *q) -> uint64_t
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(q));
+            return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle)));
+        };
+        return half(p) | (half(p + 32) << 32);
+    }
+
+    inline uint64_t ws_mask(const char *p)
+    {
+        const __m256i space = _mm256_set1_epi8(' ');
+        const __m256i tab = _mm256_set1_epi8('\t');
+        const __m256i span = _mm256_set1_epi8('\r' - '\t');
+        auto half = [&](const char *q) -> uint64_t
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(q));
+            __m256i t = _mm256_sub_epi8(v, tab);
+            __m256i ctl = _mm256_cmpeq_epi8(_mm256_min_epu8(t, span), t); // unsigned t <= span
+            __m256i ws = _mm256_or_si256(ctl, _mm256_cmpeq_epi8(v, space));
+            return static_cast<uint32_t>(_mm256_movemask_epi8(ws));
+        };
+        return half(p) | (half(p + 32) << 32);
+    }
+#elif defined(__SSE2__)
+    inline uint64_t eq_mask(const char *p, char c)
+    {
+        const __m128i needle = _mm_set1_epi8(c);
+        auto quarter = [&](const char *q) -> uint64_t
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(q));
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, needle)));
+        };
+        return quarter(p) | (quarter(p + 16) << 16) | (quarter(p + 32) << 32) |
+               (quarter(p + 48) << 48);
+    }
+
+    inline uint64_t ws_mask(const char *p)
+    {
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i span = _mm_set1_epi8('\r' - '\t');
+        auto quarter = [&](const char *q) -> uint64_t
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(q));
+            __m128i t = _mm_sub_epi8(v, tab);
+            __m128i ctl = _mm_cmpeq_epi8(_mm_min_epu8(t, span), t); // unsigned t <= span
+            __m128i ws = _mm_or_si128(ctl, _mm_cmpeq_epi8(v, space));
+            return static_cast<uint32_t>(_mm_movemask_epi8(ws));
+        };
+        return quarter(p) | (quarter(p + 16) << 16) | (quarter(p + 32) << 32) |
+               (quarter(p + 48) << 48);
+    }
+#else
+    inline uint64_t eq_mask(const char *p, char c)
+    {
+        uint64_t m = 0;
+        for (std::size_t i = 0; i < BLOCK; ++i)
+            m |= static_cast<uint64_t>(p[i] == c) << i;
+        return m;
+    }
+
+    inline uint64_t ws_mask(const char *p)
+    {
+        uint64_t m = 0;
+        for (std::size_t i = 0; i < BLOCK; ++i)
+            m |= static_cast<uint64_t>(is_ws(p[i])) << i;
+        return m;
+    }
+#endif
+}
+
+/////////////////
+// Byte search //
+/////////////////
+
+// position of the first `c` at or after `pos`, or std::string_view::npos; like
+// std::string_view::find, any `pos` is accepted
+inline std::size_t find_byte(std::string_view sv, char c, std::size_t pos = 0)
+{
+    const char *p = sv.data();
+    const std::size_t n = sv.size();
+    if (pos >= n)
+        return std::string_view::npos;
+    std::size_t i = pos;
+    for (; n - i >= sv_detail::BLOCK; i += sv_detail::BLOCK)
+        if (uint64_t m = sv_detail::eq_mask(p + i, c))
+            return i + __builtin_ctzll(m);
+    for (; i < n; ++i)
+        if (p[i] == c)
+            return i;
+    return std::string_view::npos;
+}
+
+/////////////////////////
+// Whitespace trimming //
+/////////////////////////
+
+inline std::string_view trim_left(std::string_view sv)
+{
+    const char *p = sv.data();
+    const std::size_t n = sv.size();
+    std::size_t i = 0;
+    for (; i + sv_detail::BLOCK <= n; i += sv_detail::BLOCK)
+        if (uint64_t m = ~sv_detail::ws_mask(p + i))
+            return sv.substr(i + __builtin_ctzll(m));
+    for (; i < n; ++i)
+        if (!sv_detail::is_ws(p[i]))
+            return sv.substr(i);
+    return sv.substr(n);
+}
+
+inline std::string_view trim_right(std::string_view sv)
+{
+    const char *p = sv.data();
+    std::size_t end = sv.size();
+    for (; end >= sv_detail::BLOCK; end -= sv_detail::BLOCK)
+        if (uint64_t m = ~sv_detail::ws_mask(p + end - sv_detail::BLOCK))
+            return sv.substr(0, end - __builtin_clzll(m));
+    for (; end > 0; --end)
+        if (!sv_detail::is_ws(p[end - 1]))
+            break;
+    return sv.substr(0, end);
+}
+
+inline std::string_view trim(std::string_view sv)
+{
+    return trim_right(trim_left(sv));
+}
+
+///////////////////////////
+// Splitting & line iter //
+///////////////////////////
+
+// lazily yields the pieces of a string_view between delimiters; no piece is ever copied
+class split_view
+{
+    std::string_view sv;
+    char delim;
+    bool strip_cr;
+
+public:
+    class iterator
+    {
+        std::string_view rest;
+        std::string_view cur;
+        char delim = '\0';
+        bool strip_cr = false;
+        bool done = true;
+
+        void advance()
+        {
+            if (rest.data() == nullptr)
+            {
+                done = true;
+                return;
+            }
+            std::size_t pos = find_byte(rest, delim);
+            if (pos == std::string_view::npos)
+            {
+                cur = rest;
+                rest = std::string_view();
+            }
+            else
+            {
+                cur = rest.substr(0, pos);
+                rest = rest.substr(pos + 1);
+            }
+            if (strip_cr && !cur.empty() && cur.back() == '\r')
+                cur.remove_suffix(1);
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view *;
+        using reference = const std::string_view &;
+
+        iterator() = default;
+        iterator(std::string_view sv, char delim, bool strip_cr, bool skip_last_empty)
+            : rest(sv), delim(delim), strip_cr(strip_cr), done(false)
+        {
+            // lines("a\n") yields just "a" and lines("\n") one empty line, like std::getline
+            // would; only an empty input has no lines at all
+            const bool no_input = sv.empty();
+            if (skip_last_empty && !rest.empty() && rest.back() == delim)
+                rest.remove_suffix(1);
+            if (rest.data() == nullptr)
+                rest = std::string_view("", 0);
+            if (skip_last_empty && no_input)
+                done = true;
+            else
+                advance();
+        }
+
+        reference operator*() const { return cur; }
+        pointer operator->() const { return &cur; }
+        iterator &operator++()
+        {
+            advance();
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            iterator tmp = *this;
+            advance();
+            return tmp;
+        }
+        bool operator==(const iterator &o) const
+        {
+            return done == o.done && (done || cur.data() == o.cur.data());
+        }
+        bool operator!=(const iterator &o) const { return !(*this == o); }
+    };
+
+    split_view(std::string_view sv, char delim, bool strip_cr = false)
+        : sv(sv), delim(delim), strip_cr(strip_cr) {}
+
+    iterator begin() const { return iterator(sv, delim, strip_cr, strip_cr); }
+    iterator end() const { return iterator(); }
+};
+
+// split("a,,b", ',') yields "a", "", "b"
+inline split_view split(std::string_view sv, char delim)
+{
+    return split_view(sv, delim);
+}
+
+// yields each line without its "\n" or "\r\n" terminator
+inline split_view lines(std::string_view sv)
+{
+    return split_view(sv, '\n', true);
+}
+
+#endif
@@ -0,0 +1,125 @@
+/**
+ * Copy/move accounting wrapper for tests. Requires only C++11, like utils.hpp.
+ *
+ * Tracked<T, Tag> holds a T and bumps a set of static counters in each of its special member
+ * functions, so a test can assert the exact number of copies and moves a code path performs.
+ * Counters are per (T, Tag) pair, atomic, and never allocate. Use a distinct Tag to keep the
+ * counts of unrelated users of the same T apart.
+ */
+
+#include <atomic>
+#include <type_traits>
+#include <utility>
+
+#ifndef __TRACKED_HPP__
+#define __TRACKED_HPP__
+
+struct TrackedCounts
+{
+    long constructs;      // from anything other than another Tracked
+    long copy_constructs;
+    long move_constructs;
+    long copy_assigns;
+    long move_assigns;
+    long destructs;
+
+    long copies() const { return copy_constructs + copy_assigns; }
+    long moves() const { return move_constructs + move_assigns; }
+    long alive() const { return constructs + copy_constructs + move_constructs - destructs; }
+
+    bool operator==(const TrackedCounts &o) const
+    {
+        return constructs == o.constructs && copy_constructs == o.copy_constructs &&
+               move_constructs == o.move_constructs && copy_assigns == o.copy_assigns &&
+               move_assigns == o.move_assigns && destructs == o.destructs;
+    }
+    bool operator!=(const TrackedCounts &o) const { return !(*this == o); }
+};
+
+template <typename T, typename Tag = T>
+class Tracked
+{
+private:
+    enum Counter
+    {
+        CONSTRUCT,
+        COPY_CONSTRUCT,
+        MOVE_CONSTRUCT,
+        COPY_ASSIGN,
+        MOVE_ASSIGN,
+        DESTRUCT,
+        NUM_COUNTERS
+    };
+
+    // function-local static keeps this header-only without C++17 inline variables
+    static std::atomic<long> *counters()
+    {
+        static std::atomic<long> c[NUM_COUNTERS];
+        return c;
+    }
+
+    static void bump(Counter c)
+    {
+        counters()[c].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    T value;
+
+    // true for a single argument that is itself a Tracked, which must go to the copy or move
+    // constructor rather than be forwarded to T
+    template <typename... Args>
+    struct is_self : std::false_type
+    {
+    };
+    template <typename Arg>
+    struct is_self<Arg> : std::is_same<typename std::decay<Arg>::type, Tracked>
+    {
+    };
+
+public:
+    template <typename... Args, typename = typename std::enable_if<!is_self<Args...>::value>::type>
+    explicit Tracked(Args &&...args) : value(std::forward<Args>(args)...)
+    {
+        bump(CONSTRUCT);
+    }
+    Tracked(const Tracked &o) : value(o.value) { bump(COPY_CONSTRUCT); }
+    // noexcept like T's, so containers move rather than copy while growing
+    Tracked(Tracked &&o) noexcept(std::is_nothrow_move_constructible<T>::value)
+        : value(std::move(o.value))
+    {
+        bump(MOVE_CONSTRUCT);
+    }
+    Tracked &operator=(const Tracked &o)
+    {
+        value = o.value;
+        bump(COPY_ASSIGN);
+        return *this;
+    }
+    Tracked &operator=(Tracked &&o) noexcept(std::is_nothrow_move_assignable<T>::value)
+    {
+        value = std::move(o.value);
+        bump(MOVE_ASSIGN);
+        return *this;
+    }
+    ~Tracked() { bump(DESTRUCT); }
+
+    T &get() { return value; }
+    const T &get() const { return value; }
+
+    static TrackedCounts counts()
+    {
+        std::atomic<long> *c = counters();
+        TrackedCounts s = {c[CONSTRUCT].load(), c[COPY_CONSTRUCT].load(),
+                           c[MOVE_CONSTRUCT].load(), c[COPY_ASSIGN].load(),
+                           c[MOVE_ASSIGN].load(), c[DESTRUCT].load()};
+        return s;
+    }
+
+    static void reset_counts()
+    {
+        for (int i = 0; i < NUM_COUNTERS; ++i)
+            counters()[i].store(0);
+    }
+};
+
+#endif
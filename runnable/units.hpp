@@ -0,0 +1,337 @@
+/**
+ * Strongly-typed physical quantities in the style of std::chrono::duration. Requires C++14.
+ *
+ * A unit is a dimension tag plus an affine map onto the dimension's base unit:
+ * base = value * Scale + Offset, with both given as std::ratio. Converting between two units
+ * thus folds into one multiply-add with compile-time constant coefficients, and converting
+ * between different dimensions (or mixing them in arithmetic) does not compile. As with
+ * chrono, a conversion is implicit only when it cannot lose information: the target Rep is
+ * floating point, or the source Rep is integral and the map is integral too (mile to foot, but
+ * not foot to mile, nor celsius to kelvin); anything else takes an explicit quantity_cast.
+ * Between integer reps the conversion is computed exactly in integers, truncating like
+ * duration_cast. Arithmetic and comparisons on two units go through their std::common_type,
+ * a unit both convert to exactly, so `feet + miles` is in feet whichever side each is on.
+ */
+
+#include <cstdint>
+#include <ratio>
+#include <type_traits>
+
+#ifndef __UNITS_HPP__
+#define __UNITS_HPP__
+
+namespace units
+{
+    ////////////////////////
+    // Dimensions & units //
+    ////////////////////////
+
+    struct temperature
+    {
+    };
+    struct length
+    {
+    };
+
+    template <typename Dim, typename Scale, typename Offset = std::ratio<0>>
+    struct unit
+    {
+        using dim = Dim;
+        using scale = Scale;
+        using offset = Offset;
+    };
+
+    using kelvin = unit<temperature, std::ratio<1>>;
+    using celsius = unit<temperature, std::ratio<1>, std::ratio<27315, 100>>;
+    using fahrenheit = unit<temperature, std::ratio<5, 9>, std::ratio<45967, 180>>;
+
+    using meter = unit<length, std::ratio<1>>;
+    using kilometer = unit<length, std::kilo>;
+    using foot = unit<length, std::ratio<3048, 10000>>;
+    using mile = unit<length, std::ratio<1609344, 1000>>;
+
+    template <typename Rep, typename Unit>
+    class quantity;
+
+    namespace detail
+    {
+        constexpr std::intmax_t gcd(std::intmax_t a, std::intmax_t b)
+        {
+            return b == 0 ? (a < 0 ? -a : a) : gcd(b, a % b);
+        }
+
+        template <typename From, typename To>
+        struct conversion
+        {
+            // to = from * mul + add
+            using mul = std::ratio_divide<typename From::scale, typename To::scale>;
+            using add = std::ratio_divide<std::ratio_subtract<typename From::offset,
+                                                              typename To::offset>,
+                                          typename To::scale>;
+            static constexpr bool exact = mul::den == 1 && add::den == 1;
+            // the same map over one common denominator, for exact integer arithmetic:
+            // to = (from * num + add_num) / den
+            static constexpr std::intmax_t den = mul::den / gcd(mul::den, add::den) * add::den;
+            static constexpr std::intmax_t num = mul::num * (den / mul::den);
+            static constexpr std::intmax_t add_num = add::num * (den / add::den);
+        };
+
+        // the conditions under which quantity<Rep2, Unit2> converts implicitly to
+        // quantity<Rep, Unit>
+        template <typename Rep, typename Unit, typename Rep2, typename Unit2>
+        struct is_lossless_conversion
+            : std::integral_constant<bool,
+                                     std::is_same<typename Unit::dim, typename Unit2::dim>::value &&
+                                         (std::is_floating_point<Rep>::value ||
+                                          (!std::is_floating_point<Rep2>::value &&
+                                           conversion<Unit2, Unit>::exact))>
+        {
+        };
+
+        // integer reps convert in integer arithmetic, truncating like duration_cast; a
+        // floating-point rep on either side makes the whole conversion floating point
+        template <typename To, typename Rep, typename Unit,
+                  bool Integral = std::is_integral<typename To::rep>::value &&
+                                  std::is_integral<Rep>::value>
+        struct caster
+        {
+            static constexpr To cast(const quantity<Rep, Unit> &q)
+            {
+                using c = conversion<Unit, typename To::unit_type>;
+                using CR = std::common_type_t<typename To::rep, Rep, std::intmax_t>;
+                return To(static_cast<typename To::rep>(
+                    (static_cast<CR>(q.count()) * c::num + c::add_num) / c::den));
+            }
+        };
+
+        template <typename To, typename Rep, typename Unit>
+        struct caster<To, Rep, Unit, false>
+        {
+            static constexpr To cast(const quantity<Rep, Unit> &q)
+            {
+                using c = conversion<Unit, typename To::unit_type>;
+                using CR = std::common_type_t<typename To::rep, Rep, double>;
+                constexpr CR m = static_cast<CR>(c::mul::num) / static_cast<CR>(c::mul::den);
+                constexpr CR a = static_cast<CR>(c::add::num) / static_cast<CR>(c::add::den);
+                return To(static_cast<typename To::rep>(static_cast<CR>(q.count()) * m + a));
+            }
+        };
+
+        // the largest ratio both ratios are integral multiples of; 0 is a multiple of anything
+        template <typename R1, typename R2>
+        using ratio_gcd = std::ratio<gcd(R1::num, R2::num),
+                                     R1::den / gcd(R1::den, R2::den) * R2::den>;
+
+        // a unit both units convert to exactly: the finer of the two if it is a multiple of
+        // the other (feet for feet and miles), or else their common offset if they share one,
+        // otherwise offset 0 with a scale that also divides both offsets (celsius and kelvin
+        // meet at hundredths of a kelvin)
+        template <typename U1, typename U2,
+                  bool SameOffset = std::ratio_equal<typename U1::offset,
+                                                     typename U2::offset>::value>
+        struct common_unit
+        {
+            using scale = ratio_gcd<typename U1::scale, typename U2::scale>;
+            using type = std::conditional_t<
+                std::ratio_equal<scale, typename U1::scale>::value, U1,
+                std::conditional_t<std::ratio_equal<scale, typename U2::scale>::value, U2,
+                                   unit<typename U1::dim, scale, typename U1::offset>>>;
+        };
+
+        template <typename U1, typename U2>
+        struct common_unit<U1, U2, false>
+        {
+            using type = unit<typename U1::dim,
+                              ratio_gcd<ratio_gcd<typename U1::scale, typename U2::scale>,
+                                        ratio_gcd<typename U1::offset, typename U2::offset>>>;
+        };
+
+        template <typename T>
+        struct is_quantity : std::false_type
+        {
+        };
+        template <typename Rep, typename Unit>
+        struct is_quantity<quantity<Rep, Unit>> : std::true_type
+        {
+        };
+    }
+}
+
+namespace std
+{
+    // like std::chrono::duration: the common rep over the common unit, of one dimension only
+    template <typename Rep1, typename Unit1, typename Rep2, typename Unit2>
+    struct common_type<units::quantity<Rep1, Unit1>, units::quantity<Rep2, Unit2>>
+    {
+        static_assert(is_same<typename Unit1::dim, typename Unit2::dim>::value,
+                      "quantities of different dimensions have no common type");
+        using type = units::quantity<common_type_t<Rep1, Rep2>,
+                                     typename units::detail::common_unit<Unit1, Unit2>::type>;
+    };
+}
+
+namespace units
+{
+    /////////////////
+    // Conversions //
+    /////////////////
+
+    template <typename To, typename Rep, typename Unit>
+    constexpr To quantity_cast(const quantity<Rep, Unit> &q)
+    {
+        static_assert(std::is_same<typename Unit::dim, typename To::unit_type::dim>::value,
+                      "cannot convert between quantities of different dimensions");
+        return detail::caster<To, Rep, Unit>::cast(q);
+    }
+
+    //////////////
+    // Quantity //
+    //////////////
+
+    template <typename Rep, typename Unit>
+    class quantity
+    {
+        Rep v;
+
+    public:
+        using rep = Rep;
+        using unit_type = Unit;
+
+        constexpr quantity() : v() {}
+        constexpr explicit quantity(Rep v) : v(v) {}
+        // implicit conversion from another unit of the same dimension, where it is lossless
+        template <typename Rep2, typename Unit2,
+                  typename = std::enable_if_t<
+                      detail::is_lossless_conversion<Rep, Unit, Rep2, Unit2>::value>>
+        constexpr quantity(const quantity<Rep2, Unit2> &o)
+            : v(quantity_cast<quantity>(o).count()) {}
+
+        constexpr Rep count() const { return v; }
+    };
+
+    ////////////////
+    // Arithmetic //
+    ////////////////
+
+    // mixed operands are both converted to their common type first, as with chrono, so the
+    // result never depends on the operand order
+
+    template <typename R1, typename U1, typename R2, typename U2>
+    constexpr auto operator+(const quantity<R1, U1> &a, const quantity<R2, U2> &b)
+    {
+        using CQ = std::common_type_t<quantity<R1, U1>, quantity<R2, U2>>;
+        return CQ(quantity_cast<CQ>(a).count() + quantity_cast<CQ>(b).count());
+    }
+
+    template <typename R1, typename U1, typename R2, typename U2>
+    constexpr auto operator-(const quantity<R1, U1> &a, const quantity<R2, U2> &b)
+    {
+        using CQ = std::common_type_t<quantity<R1, U1>, quantity<R2, U2>>;
+        return CQ(quantity_cast<CQ>(a).count() - quantity_cast<CQ>(b).count());
+    }
+
+    template <typename R1, typename U, typename R2,
+              typename = std::enable_if_t<!detail::is_quantity<R2>::value>>
+    constexpr auto operator*(const quantity<R1, U> &q, const R2 &k)
+    {
+        using CR = std::common_type_t<R1, R2>;
+        return quantity<CR, U>(static_cast<CR>(q.count()) * static_cast<CR>(k));
+    }
+
+    template <typename R1, typename R2, typename U,
+              typename = std::enable_if_t<!detail::is_quantity<R1>::value>>
+    constexpr auto operator*(const R1 &k, const quantity<R2, U> &q)
+    {
+        return q * k;
+    }
+
+    template <typename R1, typename U, typename R2,
+              typename = std::enable_if_t<!detail::is_quantity<R2>::value>>
+    constexpr auto operator/(const quantity<R1, U> &q, const R2 &k)
+    {
+        using CR = std::common_type_t<R1, R2>;
+        return quantity<CR, U>(static_cast<CR>(q.count()) / static_cast<CR>(k));
+    }
+
+    template <typename R1, typename U1, typename R2, typename U2>
+    constexpr bool operator==(const quantity<R1, U1> &a, const quantity<R2, U2> &b)
+    {
+        using CQ = std::common_type_t<quantity<R1, U1>, quantity<R2, U2>>;
+        return quantity_cast<CQ>(a).count() == quantity_cast<CQ>(b).count();
+    }
+
+    template <typename R1, typename U1, typename R2, typename U2>
+    constexpr bool operator<(const quantity<R1, U1> &a, const quantity<R2, U2> &b)
+    {
+        using CQ = std::common_type_t<quantity<R1, U1>, quantity<R2, U2>>;
+        return quantity_cast<CQ>(a).count() < quantity_cast<CQ>(b).count();
+    }
+
+    template <typename R1, typename U1, typename R2, typename U2>
+    constexpr bool operator!=(const quantity<R1, U1> &a, const quantity<R2, U2> &b)
+    {
+        return !(a == b);
+    }
+
+    template <typename R1, typename U1, typename R2, typename U2>
+    constexpr bool operator>(const quantity<R1, U1> &a, const quantity<R2, U2> &b)
+    {
+        return b < a;
+    }
+
+    template <typename R1, typename U1, typename R2, typename U2>
+    constexpr bool operator<=(const quantity<R1, U1> &a, const quantity<R2, U2> &b)
+    {
+        return !(b < a);
+    }
+
+    template <typename R1, typename U1, typename R2, typename U2>
+    constexpr bool operator>=(const quantity<R1, U1> &a, const quantity<R2, U2> &b)
+    {
+        return !(a < b);
+    }
+
+    template <typename Rep>
+    using kelvins = quantity<Rep, kelvin>;
+    template <typename Rep>
+    using degrees_celsius = quantity<Rep, celsius>;
+    template <typename Rep>
+    using degrees_fahrenheit = quantity<Rep, fahrenheit>;
+    template <typename Rep>
+    using meters = quantity<Rep, meter>;
+    template <typename Rep>
+    using kilometers = quantity<Rep, kilometer>;
+    template <typename Rep>
+    using feet = quantity<Rep, foot>;
+    template <typename Rep>
+    using miles = quantity<Rep, mile>;
+
+    //////////////
+    // Literals //
+    //////////////
+
+    namespace literals
+    {
+#define UNITS_LITERAL(suffix, Unit)                                          \
+    constexpr quantity<double, Unit> operator"" suffix(long double v)        \
+    {                                                                        \
+        return quantity<double, Unit>(static_cast<double>(v));               \
+    }                                                                        \
+    constexpr quantity<double, Unit> operator"" suffix(unsigned long long v) \
+    {                                                                        \
+        return quantity<double, Unit>(static_cast<double>(v));               \
+    }
+
+        UNITS_LITERAL(_kelvin, kelvin)
+        UNITS_LITERAL(_celsius, celsius)
+        UNITS_LITERAL(_fahrenheit, fahrenheit)
+        UNITS_LITERAL(_m, meter)
+        UNITS_LITERAL(_km, kilometer)
+        UNITS_LITERAL(_ft, foot)
+        UNITS_LITERAL(_mi, mile)
+
+#undef UNITS_LITERAL
+    }
+}
+
+#endif
@@ -8,6 +8,8 @@
 #include <exception>
 #include <functional>
 #include <string>
+#include <chrono>
+#include "log_stream.hpp"
 
 #ifndef __UTILS_HPP__
 #define __UTILS_HPP__
@@ -93,26 +95,74 @@ public:
 // Run stub for main //
 ///////////////////////
 
-#define RUN_EXAMPLE(func)                                   \
-    try                                                     \
-    {                                                       \
-        std::cout << "  " << #func << "... " << std::flush; \
-        func();                                             \
-        std::cout << "OK" << std::endl;                     \
-    }                                                       \
-    catch (const AssertionFailure &e)                       \
-    {                                                       \
-        std::cout << "FAILED" << std::endl                  \
-                  << "    " << e.what() << std::endl;       \
-    }                                                       \
-    catch (const ThrowingFailure &e)                        \
-    {                                                       \
-        std::cout << "FAILED" << std::endl                  \
-                  << "    " << e.what() << std::endl;       \
-    }                                                       \
-    catch (...)                                             \
-    {                                                       \
-        throw;                                              \
+#define RUN_EXAMPLE(func)                                 \
+    try                                                   \
+    {                                                     \
+        log_line() << "  " << #func << "... ";            \
+        log_out().flush(); /* visible if func crashes */  \
+        func();                                           \
+        log_line() << "OK\n";                             \
+    }                                                     \
+    catch (const AssertionFailure &e)                     \
+    {                                                     \
+        log_line() << "FAILED\n    " << e.what() << "\n"; \
+    }                                                     \
+    catch (const ThrowingFailure &e)                      \
+    {                                                     \
+        log_line() << "FAILED\n    " << e.what() << "\n"; \
+    }                                                     \
+    catch (...)                                           \
+    {                                                     \
+        log_out().flush();                                \
+        throw;                                            \
     }
 
+//////////////////////////////
+// Benchmark timing support //
+//////////////////////////////
+
+// keeps the compiler from optimizing away a value that is computed but never used
+template <typename T>
+inline void do_not_optimize(const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// runs `func` (which is expected to perform `ops` operations) a few times and returns the
+// best observed time per operation in nanoseconds
+template <typename Func>
+double time_ns_per_op(size_t ops, Func &&func, int repeats = 5)
+{
+    double best = -1;
+    for (int r = 0; r < repeats; ++r)
+    {
+        auto tps = std::chrono::steady_clock::now();
+        func();
+        auto tpe = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(tpe - tps).count() / ops;
+        if (best < 0 || ns < best)
+            best = ns;
+    }
+    return best;
+}
+
+inline void print_bench(const std::string &label, double ns_per_op)
+{
+    char num[32];
+    std::size_t n = format_fixed(num, sizeof(num), ns_per_op, 3);
+    log_line line;
+    line << "    " << label;
+    line.fill(' ', label.size() < 40 ? 40 - label.size() : 0);
+    line.fill(' ', n < 12 ? 12 - n : 0);
+    line.append(num, n) << " ns/op\n";
+}
+
+#define RUN_BENCH(func)                       \
+    do                                        \
+    {                                         \
+        log_line() << "  " << #func << ":\n"; \
+        log_out().flush();                    \
+        func();                               \
+    } while (0)
+
 #endif